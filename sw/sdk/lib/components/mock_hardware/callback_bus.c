@@ -185,6 +185,15 @@ void bus_tx_set_debugger(BusTx_t* bus)
 }
 
 
+static void bus_tx_ack(BusTx_t* bus)
+{
+    bus->rx_ack_cnt++;
+
+    if(bus->ack_handler && bus->last_write_buffer)
+        bus->ack_handler(bus, (struct Cmd_Header_t* )bus->last_write_buffer);
+}
+
+
 void bus_tx_write_async(BusTx_t* bus, uint8_t* buffer, int sz)
 {
     // should always be header otherwise rx would never work
@@ -231,7 +240,7 @@ void bus_tx_write_async(BusTx_t* bus, uint8_t* buffer, int sz)
             // Check if was not deferred
             if(!bus->tx_pio->blockingBusRx->rx_pending_buffer)
             {                
-                bus->rx_ack_cnt++; // fake ack
+                bus_tx_ack(bus); // fake ack
             }
         }
     }
@@ -654,7 +663,7 @@ void bus_rx_ack_deferred_cmd(BusRx_t* bus, Cmd_Header_t* cmd)
     // Trigger ack on remote
     BusTx_t* ackBus = bus->rx_pio->userDataTx;
     if(ackBus)
-        ackBus->rx_ack_cnt++;    
+        bus_tx_ack(ackBus);
 }
 
 
@@ -664,6 +673,12 @@ void bus_tx_reset(struct BusTx_t* busRx)
 }
 
 
+void bus_tx_set_ack_callback(BusTx_t* bus, BusMsgAckHandler_t ack_handler)
+{
+    bus->ack_handler = ack_handler;
+}
+
+
 //
 //
 int core_manager_create(struct coreManager_t* mgr)
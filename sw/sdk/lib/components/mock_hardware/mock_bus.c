@@ -758,7 +758,12 @@ int bus_tx_rpc_set_return_main(BusTx_t* bus_tx, Cmd_Header_t* reqFrameOut, Cmd_H
 }
 
 
-//void bus_tx_set_ack_callback(BusTx_t* bus, BusMsgAckHandler_t ack_handler); // global set ack handler to schedule next tx commands globayl
+void bus_tx_set_ack_callback(BusTx_t* bus, BusMsgAckHandler_t ack_handler)
+{
+    bus->ack_handler = ack_handler;
+}
+
+
 //void bus_tx_next_ack_callback(BusTx* bus, BusMsgAckHandler_t ack_handler); // next ack handler to schedule next tx command (allows contious streaming), clears on ack & overrides global
 //void bus_debug_print_frame(Cmd_Header_t* frameOut);
 
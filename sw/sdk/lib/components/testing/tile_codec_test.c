@@ -0,0 +1,284 @@
+#include "lib/components/testing/tile_codec_test.h"
+#include "lib/components/vdp2_core/tile_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TILE_CODEC_TEST_W FRAME_W
+#define TILE_CODEC_TEST_H VDP_TILEFRAME_BUFFER_Y_SIZE
+#define TILE_CODEC_TEST_CHECK(cond) if(!(cond)) { printf("[tile_codec_test] %s: failed '%s' (line %d)\n", testName, #cond, __LINE__); return false; }
+
+static struct VDP2CMD_TileFrameBuffer16bpp srcTile;        // reference tile
+static struct VDP2CMD_TileFrameBuffer16bpp packetTile;     // encoded in place
+static struct VDP2CMD_TileFrameBuffer16bpp decodedTile;
+static uint16_t ctrlScratch[TILE_CODEC_MAX_CTRL*2];      // same as vdp1
+static uint32_t bytesSavedTotal;
+
+
+//
+//
+static void tile_codec_test_init_tile(struct VDP2CMD_TileFrameBuffer16bpp* tile, uint32_t seed)
+{
+    memset(tile, 0, sizeof(*tile));
+    tile->header.cmd = EBusCmd_VDP2_TileFrameBuffer16bpp;
+    tile->header.sz = sizeof(*tile);
+    tile->cmdSeqNum = seed;
+    tile->cmdFlags = seed * 3;
+    tile->tileId = seed % FRAME_TILE_CNT_Y;
+    tile->passId = seed & 1;
+    tile->defaultBlendMode = seed & 3;
+
+    // vdp2 cmd section travels with the tile
+    tile->vdp2CmdDataCount = 2;
+    tile->vdp2CmdDataSz = 24 + (seed % 40);
+    for(int i=0;i<tile->vdp2CmdDataSz;i++)
+        tile->vdp2CmdData[i] = rand();
+}
+
+
+static void tile_codec_test_fill_noise(struct VDP2CMD_TileFrameBuffer16bpp* tile)
+{
+    for(int i=0;i<NUM_ELEMS(tile->pixels);i++)
+        tile->pixels[i] = rand();
+    for(int i=0;i<NUM_ELEMS(tile->attr);i++)
+        tile->attr[i] = rand();
+}
+
+
+static void tile_codec_test_fill_structured(struct VDP2CMD_TileFrameBuffer16bpp* tile, int pattern)
+{
+    for(int y=0;y<TILE_CODEC_TEST_H;y++)
+    {
+        for(int x=0;x<TILE_CODEC_TEST_W;x++)
+        {
+            int i = x + (y * TILE_CODEC_TEST_W);
+            uint16_t col = 0;
+            uint8_t a = 0;
+            switch(pattern)
+            {
+            case 0: // clear
+                break;
+            case 1: // sky gradient with sprites
+                col = 0x1f + (y << 5);
+                if((x / 24) % 3 == 1 && (y / 12) % 2 == 0)
+                {
+                    col = rand();
+                    a = 0xf;
+                }
+                break;
+            case 2: // vertical bars, run per bar per row
+                col = (x / 32) & 1 ? 0xf800 : 0x07e0;
+                a = (x / 32) & 1;
+                break;
+            case 3: // checker of 16x16 blocks
+                col = ((x / 16) ^ (y / 16)) & 1 ? 0xffff : 0;
+                a = 0x3;
+                break;
+            }
+            tile->pixels[i] = col;
+            tile->attr[i] = a;
+        }
+    }
+}
+
+
+/** Encode srcTile, returns packet size or 0 for raw. Checks raw fallback leaves the packet untouched */
+static uint32_t tile_codec_test_encode(const char* testName, bool encodePlanes, bool attrUniform)
+{
+    memcpy(&packetTile, &srcTile, sizeof(packetTile));
+    uint32_t sz = tile_codec_compress_tile16bpp(&packetTile, ctrlScratch, NUM_ELEMS(ctrlScratch), encodePlanes, attrUniform);
+    if(!sz)
+    {
+        if(memcmp(&packetTile, &srcTile, sizeof(packetTile)) != 0)
+        {
+            printf("[tile_codec_test] %s: raw fallback modified tile\n", testName);
+            return (uint32_t)-1;
+        }
+        return 0;
+    }
+
+    // bytes saved as reported by vdp1, sent packet is header sized
+    bytesSavedTotal += sizeof(packetTile) - sz;
+    return sz;
+}
+
+
+static bool tile_codec_test_round_trip(const char* testName, uint32_t sz, bool attrUniform)
+{
+    TILE_CODEC_TEST_CHECK(sz != (uint32_t)-1);
+    TILE_CODEC_TEST_CHECK(sz > 0);
+    TILE_CODEC_TEST_CHECK(packetTile.header.cmd == EBusCmd_VDP2_TileFrameBuffer16bppRLE);
+    TILE_CODEC_TEST_CHECK(packetTile.header.sz == sz);
+    TILE_CODEC_TEST_CHECK(sz <= sizeof(packetTile) - (sizeof(packetTile) / 8));
+
+    memset(&decodedTile, 0xcd, sizeof(decodedTile));
+    TILE_CODEC_TEST_CHECK(tile_codec_decompress_tile16bpp((const struct VDP2CMD_TileFrameBuffer16bppRLE*)&packetTile, &decodedTile));
+    TILE_CODEC_TEST_CHECK(decodedTile.header.cmd == EBusCmd_VDP2_TileFrameBuffer16bpp);
+    TILE_CODEC_TEST_CHECK(decodedTile.header.sz == sizeof(decodedTile));
+    TILE_CODEC_TEST_CHECK(decodedTile.cmdSeqNum == srcTile.cmdSeqNum);
+    TILE_CODEC_TEST_CHECK(decodedTile.cmdFlags == srcTile.cmdFlags);
+    TILE_CODEC_TEST_CHECK(decodedTile.tileId == srcTile.tileId);
+    TILE_CODEC_TEST_CHECK(decodedTile.passId == srcTile.passId);
+    TILE_CODEC_TEST_CHECK(decodedTile.defaultBlendMode == srcTile.defaultBlendMode);
+    TILE_CODEC_TEST_CHECK(decodedTile.vdp2CmdDataCount == srcTile.vdp2CmdDataCount);
+    TILE_CODEC_TEST_CHECK(decodedTile.vdp2CmdDataSz == srcTile.vdp2CmdDataSz);
+    TILE_CODEC_TEST_CHECK(memcmp(decodedTile.vdp2CmdData, srcTile.vdp2CmdData, srcTile.vdp2CmdDataSz) == 0);
+    TILE_CODEC_TEST_CHECK(memcmp(decodedTile.pixels, srcTile.pixels, sizeof(srcTile.pixels)) == 0);
+
+    // uniform attr decodes to first attr
+    if(attrUniform)
+    {
+        for(int i=0;i<NUM_ELEMS(decodedTile.attr);i++)
+            TILE_CODEC_TEST_CHECK(decodedTile.attr[i] == srcTile.attr[0]);
+    }
+    else
+        TILE_CODEC_TEST_CHECK(memcmp(decodedTile.attr, srcTile.attr, sizeof(srcTile.attr)) == 0);
+    return true;
+}
+
+
+static const VDP2TileRLETrailer* tile_codec_test_get_trailer()
+{
+    return (const VDP2TileRLETrailer*)((const uint8_t*)&packetTile + packetTile.header.sz - sizeof(VDP2TileRLETrailer));
+}
+
+
+//
+//
+static bool tile_codec_test_random()
+{
+    const char* testName = "random";
+    for(int i=0;i<32;i++)
+    {
+        tile_codec_test_init_tile(&srcTile, i);
+        tile_codec_test_fill_noise(&srcTile);
+        uint32_t saved = bytesSavedTotal;
+
+        // noise never pays off, raw kept & nothing counted
+        TILE_CODEC_TEST_CHECK(tile_codec_test_encode(testName, true, false) == 0);
+        TILE_CODEC_TEST_CHECK(bytesSavedTotal == saved);
+    }
+    return true;
+}
+
+
+static bool tile_codec_test_structured()
+{
+    const char* testName = "structured";
+    for(int pattern=0;pattern<4;pattern++)
+    {
+        tile_codec_test_init_tile(&srcTile, pattern);
+        tile_codec_test_fill_structured(&srcTile, pattern);
+        uint32_t sz = tile_codec_test_encode(testName, true, false);
+        if(!tile_codec_test_round_trip(testName, sz, false))
+            return false;
+        TILE_CODEC_TEST_CHECK((tile_codec_test_get_trailer()->flags & (TILE_CODEC_FLAG_RAW_PIXELS | TILE_CODEC_FLAG_RAW_ATTR)) == 0);
+    }
+    return true;
+}
+
+
+static bool tile_codec_test_uniform_attr()
+{
+    const char* testName = "uniform_attr";
+
+    // noisy pixels are sent raw, attr collapses to 1 byte
+    tile_codec_test_init_tile(&srcTile, 7);
+    tile_codec_test_fill_noise(&srcTile);
+    uint32_t sz = tile_codec_test_encode(testName, false, true);
+    if(!tile_codec_test_round_trip(testName, sz, true))
+        return false;
+    const VDP2TileRLETrailer* trailer = tile_codec_test_get_trailer();
+    TILE_CODEC_TEST_CHECK(trailer->flags == (TILE_CODEC_FLAG_RAW_PIXELS | TILE_CODEC_FLAG_UNIFORM_ATTR));
+    TILE_CODEC_TEST_CHECK(trailer->attrDataCnt == 1);
+    return true;
+}
+
+
+static bool tile_codec_test_ctrl_overflow()
+{
+    const char* testName = "ctrl_overflow";
+
+    // plane codecs fail once ctrl is full, size pass only
+    static uint16_t data16[64];
+    static uint8_t data8[64];
+    for(int i=0;i<64;i++)
+    {
+        data16[i] = (i % 4) == 3 ? i : 0xaaaa;   // run + literal per 4 elements
+        data8[i] = (i % 5) == 4 ? i : 0x55;
+    }
+    uint32_t dataCnt = 0;
+    TILE_CODEC_TEST_CHECK(tile_codec_encode_rle16(data16, 64, ctrlScratch, 4, false, &dataCnt) == -1);
+    TILE_CODEC_TEST_CHECK(tile_codec_encode_rle16(data16, 64, ctrlScratch, 32, false, &dataCnt) == 32);
+    TILE_CODEC_TEST_CHECK(dataCnt == 32);
+    TILE_CODEC_TEST_CHECK(tile_codec_encode_rle8(data8, 64, ctrlScratch, 4, false, &dataCnt) == -1);
+
+    // pixel ctrl overflows the per plane budget, pixels fall back to raw while attr still encodes
+    tile_codec_test_init_tile(&srcTile, 11);
+    for(int i=0;i<NUM_ELEMS(srcTile.pixels);i++)
+        srcTile.pixels[i] = (i % 4) == 3 ? rand() : 0x1234;
+    memset(srcTile.attr, 0x0f, sizeof(srcTile.attr));
+    uint32_t sz = tile_codec_test_encode(testName, true, false);
+    if(!tile_codec_test_round_trip(testName, sz, false))
+        return false;
+    const VDP2TileRLETrailer* trailer = tile_codec_test_get_trailer();
+    TILE_CODEC_TEST_CHECK(trailer->flags == TILE_CODEC_FLAG_RAW_PIXELS);
+    TILE_CODEC_TEST_CHECK(trailer->pixelCtrlCnt == 0);
+    TILE_CODEC_TEST_CHECK(trailer->pixelDataCnt == NUM_ELEMS(srcTile.pixels));
+
+    // both planes overflow, nothing saved so raw packet is kept
+    for(int i=0;i<NUM_ELEMS(srcTile.attr);i++)
+        srcTile.attr[i] = (i % 5) == 4 ? rand() : 0x0f;
+    TILE_CODEC_TEST_CHECK(tile_codec_test_encode(testName, true, false) == 0);
+    return true;
+}
+
+
+static bool tile_codec_test_bytes_saved()
+{
+    const char* testName = "bytes_saved";
+
+    // counter sums header sized packets against the raw tile, as vdp1 reports it
+    bytesSavedTotal = 0;
+    uint32_t expected = 0;
+    for(int pattern=0;pattern<4;pattern++)
+    {
+        tile_codec_test_init_tile(&srcTile, pattern);
+        tile_codec_test_fill_structured(&srcTile, pattern);
+        uint32_t sz = tile_codec_test_encode(testName, true, false);
+        TILE_CODEC_TEST_CHECK(sz > 0 && sz != (uint32_t)-1);
+        expected += sizeof(srcTile) - packetTile.header.sz;
+    }
+    tile_codec_test_init_tile(&srcTile, 4);
+    tile_codec_test_fill_noise(&srcTile);
+    TILE_CODEC_TEST_CHECK(tile_codec_test_encode(testName, true, false) == 0);
+
+    TILE_CODEC_TEST_CHECK(bytesSavedTotal == expected);
+    TILE_CODEC_TEST_CHECK(bytesSavedTotal >= 4 * (sizeof(srcTile) / 8));
+    return true;
+}
+
+
+bool tile_codec_test_run()
+{
+    srand(1);
+    bytesSavedTotal = 0;
+
+    bool passed = true;
+    passed &= tile_codec_test_random();
+    passed &= tile_codec_test_structured();
+    passed &= tile_codec_test_uniform_attr();
+    passed &= tile_codec_test_ctrl_overflow();
+    passed &= tile_codec_test_bytes_saved();
+
+    printf("[tile_codec_test] %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+
+#ifdef TILE_CODEC_TEST_MAIN
+int main()
+{
+    return tile_codec_test_run() ? 0 : 1;
+}
+#endif
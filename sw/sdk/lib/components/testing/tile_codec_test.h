@@ -0,0 +1,8 @@
+#pragma once
+
+#include "picocom/platform.h"
+
+/** Host side tile codec round trip test, see tile_codec.h.
+ * Build standalone with TILE_CODEC_TEST_MAIN or call from a sim target.
+*/
+bool tile_codec_test_run();     // Run all cases, returns true when all passed
@@ -0,0 +1,217 @@
+#include "lib/components/testing/vdp_client_overflow_test.h"
+#include "lib/components/vdp1_core/vdp_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VDP_CLIENT_OVERFLOW_TEST_LIST_SZ (sizeof(struct VDP1CMD_DrawCmdData) + 256)  // ~11 fill cmds per packet
+#define VDP_CLIENT_OVERFLOW_TEST_MAX_CMDS 256
+#define VDP_CLIENT_OVERFLOW_TEST_MAX_ACKS 16
+#define VDP_CLIENT_OVERFLOW_TEST_VDP2_SZ 40
+#define VDP_CLIENT_OVERFLOW_TEST_CHECK(cond) if(!(cond)) { printf("[vdp_client_overflow_test] %s: failed '%s' (line %d)\n", testName, #cond, __LINE__); return false; }
+
+static struct BusTx_t testBusTx;
+static struct BusRx_t testBusRx;
+
+// acks are delivered on next rx update, as the vdp1 would
+static uint32_t pendingAcks[VDP_CLIENT_OVERFLOW_TEST_MAX_ACKS];
+static uint32_t pendingAckCnt;
+
+// received per frame
+static uint16_t cmdBandMask[VDP_CLIENT_OVERFLOW_TEST_MAX_CMDS];            // bands each cmd was submitted to
+static uint8_t bandCmdCnt[FRAME_TILE_CNT_Y][VDP_CLIENT_OVERFLOW_TEST_MAX_CMDS]; // times each band received cmd
+static uint8_t vdp2CmdData[VDP_CLIENT_OVERFLOW_TEST_VDP2_SZ];              // vdp2 section sent with frame
+static uint32_t packetCnt;
+static uint32_t packetVdp2Cnt;      // packets carrying the vdp2 section
+static uint32_t packetFlipCnt;      // packets flagged with frame end flags
+static uint32_t packetErrors;       // malformed packets
+
+
+#ifdef VDP_CLIENT_OVERFLOW_TEST_MAIN
+
+//
+// Fakes, client only needs a bus that acks draw packets
+void bus_rx_set_callback(BusRx_t* bus, BusMsgHandler_t irq_handler, BusMsgHandler_t main_handler)
+{
+    bus->rx_irq_handler = irq_handler;
+    bus->rx_main_handler = main_handler;
+}
+
+void bus_rx_push_defer_cmd(BusRx_t* bus, Cmd_Header_t* cmd) {}
+int bus_tx_update(BusTx_t* bus) { return 0; }
+
+void bus_rx_update(struct BusRx_t* busRx)
+{
+    uint32_t ackCnt = pendingAckCnt;
+    pendingAckCnt = 0;
+    for(int i=0;i<ackCnt;i++)
+    {
+        struct VDP1CMD_AckDrawCmdData ack = {};
+        BUS_INIT_CMD(ack, EBusCmd_VDP1_AckDrawCmdData);
+        ack.cmdSeqNum = pendingAcks[i];
+        busRx->rx_main_handler(busRx, &ack.header);
+    }
+}
+
+int bus_tx_request_blocking_ex(BusTx_t* bus_tx, BusRx_t* bus_rx, Cmd_Header_t* frameOut, Cmd_Header_t* frameResponse, size_t responseSize, uint32_t timeoutMs, BlockingServiceCallHandler_t handler, void* userData)
+{
+    return SDKErr_Fail;
+}
+
+uint64_t picocom_time_us_64() { return 0; }
+void tight_loop_contents() {}
+
+void picocom_panic(int errorCode, const char* message)
+{
+    printf("[vdp_client_overflow_test] panic %d: %s\n", errorCode, message);
+    exit(1);
+}
+
+uint8_t* gpu_malloc(uint32_t sz)
+{
+    return (uint8_t*)picocom_malloc(sz);
+}
+
+// test cmds only use tile cull masks
+uint16_t gpu_calc_cmd_tile_mask(GpuCmd_Header* header, uint16_t allTilesMask)
+{
+    if( header->flags & EGpuCmd_Header_Flags_TileCullMask )
+        return allTilesMask & header->cullTileMask;
+    return allTilesMask;
+}
+
+
+/** Record cmds received per band, queues ack */
+void bus_tx_write_cmd_async(BusTx_t* bus, Cmd_Header_t* frameOut)
+{
+    struct VDP1CMD_DrawCmdData* packet = (struct VDP1CMD_DrawCmdData*)frameOut;
+    packetCnt++;
+    if(packet->header.cmd != EBusCmd_VDP1_DrawCmdData || pendingAckCnt >= VDP_CLIENT_OVERFLOW_TEST_MAX_ACKS)
+    {
+        packetErrors++;
+        return;
+    }
+    pendingAcks[pendingAckCnt++] = packet->cmdSeqNum;
+
+    if(packet->cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay)
+        packetFlipCnt++;
+
+    // vdp2 section is sent whole or not at all
+    if(packet->vdp2CmdDataSz)
+    {
+        if(packet->vdp2CmdDataSz != sizeof(vdp2CmdData) || packet->vdp2CmdDataCount != 2 || memcmp(packet->vdp2CmdData, vdp2CmdData, sizeof(vdp2CmdData)) != 0)
+            packetErrors++;
+        packetVdp2Cnt++;
+    }
+
+    uint32_t offset = 0;
+    for(int index=0;index<packet->cmdDataCount;index++)
+    {
+        struct GPUCMD_FillRectCol* cmd = (struct GPUCMD_FillRectCol*)(packet->cmdData + offset);
+        if(offset + sizeof(*cmd) > packet->cmdDataSz || cmd->header.cmd != EGPUCMD_FillRectCol || cmd->col >= VDP_CLIENT_OVERFLOW_TEST_MAX_CMDS)
+        {
+            packetErrors++;
+            return;
+        }
+        offset += cmd->header.sz;
+
+        for(int band=0;band<FRAME_TILE_CNT_Y;band++)
+        {
+            if(packet->tileMask & cmdBandMask[cmd->col] & (1 << band))
+                bandCmdCnt[band][cmd->col]++;
+        }
+    }
+}
+
+#endif
+
+
+static struct VdpClientImpl_t* vdp_client_overflow_test_init(uint32_t binListCnt)
+{
+    struct VdpClientInitOptions_t options = {};
+    options.vdp1Link_tx = &testBusTx;
+    options.vdp1Link_rx = &testBusRx;
+    options.cmdListPoolCnt = 2;             // as display
+    options.cmdListAllocSize = VDP_CLIENT_OVERFLOW_TEST_LIST_SZ;
+    options.overflowBinAllocSize = VDP_CLIENT_OVERFLOW_TEST_LIST_SZ * binListCnt;
+    return vdp1_client_init(&options);
+}
+
+
+/** Submit a frame of cmdCnt fill cmds, each culled to a random band range or bandOnly when set. Checks each band renders its cmds once */
+static bool vdp_client_overflow_test_frame(const char* testName, uint32_t binListCnt, uint32_t cmdCnt, int bandOnly, bool vdp2SectionEveryPacket)
+{
+    memset(bandCmdCnt, 0, sizeof(bandCmdCnt));
+    packetCnt = 0;
+    packetVdp2Cnt = 0;
+    packetFlipCnt = 0;
+    packetErrors = 0;
+
+    struct VdpClientImpl_t* client = vdp_client_overflow_test_init(binListCnt);
+    VDP_CLIENT_OVERFLOW_TEST_CHECK(client);
+
+    uint16_t allBands = (1 << FRAME_TILE_CNT_Y) - 1;
+    VDP_CLIENT_OVERFLOW_TEST_CHECK(vdp1_begin_frame(client, allBands, EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay) == SDKErr_OK);
+
+    // vdp2 section, copied between band packets
+    for(int i=0;i<sizeof(vdp2CmdData);i++)
+        vdp2CmdData[i] = rand();
+    for(int i=0;i<2;i++)
+    {
+        uint32_t sz = sizeof(vdp2CmdData) / 2;
+        uint8_t* dst = (uint8_t*)vdp1_cmd_add_next(client, 1, sz);
+        VDP_CLIENT_OVERFLOW_TEST_CHECK(dst);
+        memcpy(dst, vdp2CmdData + (i * sz), sz);
+    }
+
+    for(int i=0;i<cmdCnt;i++)
+    {
+        int minBand = bandOnly >= 0 ? bandOnly : rand() % FRAME_TILE_CNT_Y;
+        int maxBand = bandOnly >= 0 ? bandOnly : minBand + (rand() % (FRAME_TILE_CNT_Y - minBand));
+        cmdBandMask[i] = ((1 << (maxBand + 1)) - 1) & ~((1 << minBand) - 1);
+
+        struct GPUCMD_FillRectCol* cmd = (struct GPUCMD_FillRectCol*)vdp1_cmd_add_next(client, 0, sizeof(struct GPUCMD_FillRectCol));
+        VDP_CLIENT_OVERFLOW_TEST_CHECK(cmd);
+        GPU_INIT_CMD(cmd, EGPUCMD_FillRectCol);
+        cmd->header.flags = EGpuCmd_Header_Flags_TileCullMask;
+        cmd->header.cullTileMask = cmdBandMask[i];
+        cmd->col = i;  // cmd id
+    }
+
+    VDP_CLIENT_OVERFLOW_TEST_CHECK(vdp1_end_frame(client, true, true) == SDKErr_OK);
+
+    VDP_CLIENT_OVERFLOW_TEST_CHECK(packetErrors == 0);
+    VDP_CLIENT_OVERFLOW_TEST_CHECK(packetFlipCnt == 1);
+    VDP_CLIENT_OVERFLOW_TEST_CHECK(packetVdp2Cnt > 0);
+    if(vdp2SectionEveryPacket)
+        VDP_CLIENT_OVERFLOW_TEST_CHECK(packetVdp2Cnt == packetCnt);
+    for(int band=0;band<FRAME_TILE_CNT_Y;band++)
+    {
+        for(int i=0;i<cmdCnt;i++)
+            VDP_CLIENT_OVERFLOW_TEST_CHECK(bandCmdCnt[band][i] == ((cmdBandMask[i] & (1 << band)) ? 1 : 0));
+    }
+    return true;
+}
+
+
+bool vdp_client_overflow_test_run()
+{
+    srand(1);
+
+    bool passed = true;
+    passed &= vdp_client_overflow_test_frame("band_groups", 16, 60, -1, true);        // frame fits bins, sent per band group
+    passed &= vdp_client_overflow_test_frame("bins_full", 2, 60, -1, false);          // bins flushed mid frame as passes
+    passed &= vdp_client_overflow_test_frame("split_band", 16, 40, 2, true);          // single band overflows a packet
+    passed &= vdp_client_overflow_test_frame("no_spill", 16, 4, -1, true);            // fits current list
+
+    printf("[vdp_client_overflow_test] %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+
+#ifdef VDP_CLIENT_OVERFLOW_TEST_MAIN
+int main()
+{
+    return vdp_client_overflow_test_run() ? 0 : 1;
+}
+#endif
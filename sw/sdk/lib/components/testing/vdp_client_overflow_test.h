@@ -0,0 +1,8 @@
+#pragma once
+
+#include "picocom/platform.h"
+
+/** Host side vdp1 client overflow binning test, see vdp1_client_commit_overflow_bins.
+ * Build standalone with VDP_CLIENT_OVERFLOW_TEST_MAIN, bus and gpu deps are faked.
+*/
+bool vdp_client_overflow_test_run();     // Run all cases, returns true when all passed
@@ -32,76 +32,126 @@ static void app_handler_realtime(struct BusRx_t* bus, struct Cmd_Header_t* frame
 }
 
 
-static void vdp1_send_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct tileListJob_t* job)
+static void vdp1_tile_sent_handler(struct BusTx_t* bus, struct Cmd_Header_t* frame)
 {
-    switch (job->cmdIn->colorDepth)
+    struct vdp1_t* vdp = (struct vdp1_t*)bus->userData;
+
+    // release tile buffer, can be rendered into again
+    for(int i=0;i<NUM_ELEMS(vdp->tileCmdOut);i++)
     {
-    case EColorDepth_BGR565:
+        if(frame == vdp->tileCmdOut[i])
+            vdp->tileCmdOutInFlight[i] = false;
+    }
+}
+
+
+static void vdp1_wait_tile_cmd_out(struct vdp1_t* vdp, uint32_t tileCmdId)
+{
+    while(vdp->tileCmdOutInFlight[tileCmdId])
     {
-        const struct VDP1CMD_DrawCmdData* cmd = job->cmdIn;
-        struct VDP2CMD_TileFrameBuffer16bpp* tileCmdOut = (struct VDP2CMD_TileFrameBuffer16bpp*)job->tileCmdOut;    
+        // ack timeouts dont fire handler, bus idle means sent
+        if(!bus_tx_is_busy(vdp->vdp2_vdbus_tx))
+        {
+            vdp->tileCmdOutInFlight[tileCmdId] = false;
+            break;
+        }
+        tight_loop_contents();
+    }
+}
 
-        if(cmd->cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_WriteVDP2Tile ) 
-        {        
-            uint32_t tileBusCopyStartTime = picocom_time_us_32();
 
-            BEGIN_PROFILE()
-            mutex_enter_blocking(&vdp->sendLock);
+static void vdp1_send_tile_cmd_async(struct vdp1_t* vdp, struct tileListJob_t* job, struct Cmd_Header_t* header, uint32_t sz)
+{
+    uint32_t tileBusCopyStartTime = picocom_time_us_32();
 
-            // wait bus                        
-            bus_tx_wait(vdp->vdp2_vdbus_tx);  
+    mutex_enter_blocking(&vdp->sendLock);
 
-            //printf("[vdp1] upload tile passId:%d, tileId: %d\n", job->cmdIn->passId, job->tileFrameBuffer.tileId);
-            
-            // write jobA to vdp2
-            //LOG_BUS_CMD("[vdp1] upload tile cmdSeqNum:%d, tileId: %d\n", job->cmdSeqNum, job->tileFrameBuffer.tileId);
-            bus_tx_write_async(vdp->vdp2_vdbus_tx, (uint8_t*)&tileCmdOut->header, sizeof(*tileCmdOut));
+    // wait prev tile
+    bus_tx_wait(vdp->vdp2_vdbus_tx);  
 
-            // wait bus                        
-            bus_tx_wait(vdp->vdp2_vdbus_tx);
+    for(int i=0;i<NUM_ELEMS(vdp->tileCmdOut);i++)
+    {
+        if(header == vdp->tileCmdOut[i])
+            vdp->tileCmdOutInFlight[i] = true;
+    }
 
-            mutex_exit(&vdp->sendLock);
+    //printf("[vdp1] upload tile passId:%d, tileId: %d\n", job->cmdIn->passId, job->tileFrameBuffer.tileId);
+    
+    // write job to vdp2, dma runs while next tile renders. Buffer released in vdp1_tile_sent_handler
+    bus_tx_write_async(vdp->vdp2_vdbus_tx, (uint8_t*)header, sz);
 
-            // profile
-            job->tileBusCopyTookTime = picocom_time_us_32() - tileBusCopyStartTime;    
+    mutex_exit(&vdp->sendLock);
 
-            //END_PROFILE_BLOCK_US();
-            //printf("\tvdp1_send_tile_job[%d] took: %d us (%d ms)\n", coreId, t1-t0, (t1-t0)/1000); 
-        }         
-        break;
-    }
-    case EColorDepth_8BPP:
-    {
-        const struct VDP1CMD_DrawCmdData* cmd = job->cmdIn;
-        struct VDP2CMD_TileFrameBuffer8bpp* tileCmdOut = (struct VDP2CMD_TileFrameBuffer8bpp*)job->tileCmdOut;    
+    // profile, time stalled on bus
+    job->tileBusCopyTookTime = picocom_time_us_32() - tileBusCopyStartTime;    
+}
 
-        if(cmd->cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_WriteVDP2Tile ) 
-        {        
-            uint32_t tileBusCopyStartTime = picocom_time_us_32();
 
-            BEGIN_PROFILE()
-            mutex_enter_blocking(&vdp->sendLock);
+#ifdef VDP1_TILE_UNIFORM_ATTR
+static bool vdp1_tile_attr_used(const struct VDP1CMD_DrawCmdData* cmd)
+{
+    // vdp2 cmds may comp with any blend, default comp only reads attr for alpha modes
+    if(cmd->vdp2CmdDataCount > 0)
+        return true;
 
-            // wait bus                        
-            bus_tx_wait(vdp->vdp2_vdbus_tx);  
+    switch (cmd->defaultBlendMode)
+    {
+    case EBlendMode_Alpha:
+    case EBlendMode_DebugAttrAlpha:
+    case EBlendMode_DebugAttrPixelWriteMask:
+        return true;
+    default:
+        return false;
+    }
+}
 
-            //printf("[vdp1] upload tile passId:%d, tileId: %d\n", job->cmdIn->passId, job->tileFrameBuffer.tileId);
-            
-            // write jobA to vdp2
-            //LOG_BUS_CMD("[vdp1] upload tile cmdSeqNum:%d, tileId: %d\n", job->cmdSeqNum, job->tileFrameBuffer.tileId);
-            bus_tx_write_async(vdp->vdp2_vdbus_tx, (uint8_t*)&tileCmdOut->header, sizeof(*tileCmdOut));
 
-            // wait bus                        
-            bus_tx_wait(vdp->vdp2_vdbus_tx);
+static bool vdp1_tile_attr_uniform(struct tileListJob_t* jobs, uint32_t jobCnt)
+{
+    for(int i=0;i<jobCnt;i++)
+    {
+        if(!jobs[i].attrUniform || jobs[i].attrValue != jobs[0].attrValue)
+            return false;
+    }
+    return true;
+}
+#endif
 
-            mutex_exit(&vdp->sendLock);
 
-            // profile
-            job->tileBusCopyTookTime = picocom_time_us_32() - tileBusCopyStartTime;    
+static void vdp1_send_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct tileListJob_t* job)
+{
+    if((job->cmdIn->cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_WriteVDP2Tile) == 0)
+        return;
 
-            //END_PROFILE_BLOCK_US();
-            //printf("\tvdp1_send_tile_job[%d] took: %d us (%d ms)\n", coreId, t1-t0, (t1-t0)/1000); 
-        }         
+    switch (job->cmdIn->colorDepth)
+    {
+    case EColorDepth_BGR565:
+    {
+        struct VDP2CMD_TileFrameBuffer16bpp* tileCmdOut = (struct VDP2CMD_TileFrameBuffer16bpp*)job->tileCmdOut;    
+        uint32_t sz = sizeof(*tileCmdOut);
+        bool encodePlanes = false;
+        bool attrUniform = false;
+#ifdef VDP1_TILE_COMPRESSION
+        encodePlanes = true;
+#endif
+#ifdef VDP1_TILE_UNIFORM_ATTR
+        // slices share tile out, attr uniform when all slices agree
+        attrUniform = !vdp1_tile_attr_used(job->cmdIn) || vdp1_tile_attr_uniform(vdp->jobs, VDP1_TILE_SLICE_CNT);
+#endif
+        // compress in place, buffer is fully re-rendered before reuse
+        uint32_t compressedSz = tile_codec_compress_tile16bpp(tileCmdOut, vdp->tileCodecCtrl, NUM_ELEMS(vdp->tileCodecCtrl), encodePlanes, attrUniform);
+        if(compressedSz)
+        {
+            job->tileBusBytesSaved = sz - compressedSz;
+            sz = compressedSz;
+        }
+        vdp1_send_tile_cmd_async(vdp, job, &tileCmdOut->header, sz);
+        break;
+    }
+    case EColorDepth_8BPP:
+    {
+        struct VDP2CMD_TileFrameBuffer8bpp* tileCmdOut = (struct VDP2CMD_TileFrameBuffer8bpp*)job->tileCmdOut;    
+        vdp1_send_tile_cmd_async(vdp, job, &tileCmdOut->header, sizeof(*tileCmdOut));
         break;
     }    
     default:
@@ -124,16 +174,20 @@ static void vdp1_render_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct til
 
         struct GpuInstance_t gpuInstance;
         gpu_init_instance(vdp->gpuState, &gpuInstance, coreId);
+        gpuInstance.subTileId = job->subTileId;
+        gpuInstance.trustedCmds = job->cmdListTrusted;
+        gpuInstance.enableProfiler = vdp->profilerEnabled;
+        gpuInstance.frameProfile = &vdp->coreProfile[coreId];
 
         BUS_INIT_CMD_PTR(tileCmdOut, EBusCmd_VDP2_TileFrameBuffer16bpp);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Waddress-of-packed-member"        
-        job->tileFrameBuffer.pixelsData = (uint8_t*)(tileCmdOut->pixels + ( job->subTileId ?  (FRAME_W*(FRAME_TILE_SZ_Y / 2)) : 0 ));
-        job->tileFrameBuffer.attr = tileCmdOut->attr +  ( job->subTileId ?  (FRAME_W*(FRAME_TILE_SZ_Y / 2)) : 0 );
+        job->tileFrameBuffer.pixelsData = (uint8_t*)(tileCmdOut->pixels + (FRAME_W * VDP1_TILE_SLICE_SZ_Y * job->subTileId));
+        job->tileFrameBuffer.attr = tileCmdOut->attr + (FRAME_W * VDP1_TILE_SLICE_SZ_Y * job->subTileId);
         job->tileFrameBuffer.w = FRAME_W;
-        job->tileFrameBuffer.h = FRAME_TILE_SZ_Y / 2;
+        job->tileFrameBuffer.h = VDP1_TILE_SLICE_SZ_Y;
         job->tileFrameBuffer.tileId = tileId;
-        job->tileFrameBuffer.y = (tileId * FRAME_TILE_SZ_Y) + (job->subTileId * (FRAME_TILE_SZ_Y / 2));
+        job->tileFrameBuffer.y = (tileId * FRAME_TILE_SZ_Y) + (job->subTileId * VDP1_TILE_SLICE_SZ_Y);
         job->tileFrameBuffer.colorDepth = EColorDepth_BGR565;
 #pragma GCC diagnostic pop  
 
@@ -156,8 +210,6 @@ static void vdp1_render_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct til
         // Tile filter
         if( (cmd->tileMask & (1 << tileId)) != 0 )
         {
-            BEGIN_PROFILE();        
-
             // copy cmds
             tileCmdOut->vdp2CmdDataCount = cmd->vdp2CmdDataCount;
             tileCmdOut->vdp2CmdDataSz = cmd->vdp2CmdDataSz;
@@ -166,15 +218,22 @@ static void vdp1_render_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct til
             uint32_t tileRenderStartTime = picocom_time_us_32();
 
             // run job in core1 ( in parallel with core 2 )
-            memset( job->tileFrameBuffer.pixelsData, 0, sizeof(tileCmdOut->pixels) / 2);    
-            memset( job->tileFrameBuffer.attr , 0, sizeof(tileCmdOut->attr) / 2);
+            memset( job->tileFrameBuffer.pixelsData, 0, sizeof(tileCmdOut->pixels) / VDP1_TILE_SLICE_CNT);    
+            memset( job->tileFrameBuffer.attr , 0, sizeof(tileCmdOut->attr) / VDP1_TILE_SLICE_CNT);
 
             // render gpu cmds                
             gpu_clear_error_stats(vdp->gpuState, &gpuInstance);
             gpu_begin_frame(vdp->gpuState, &gpuInstance, cmd->cmdSeqNum);
-            gpu_run_tile(vdp->gpuState, &gpuInstance, (GpuCommandList_t*)&cmdList, &job->tileFrameBuffer);            // Render command into tile
+            gpu_run_tile_binned(vdp->gpuState, &gpuInstance, (GpuCommandList_t*)&cmdList, job->tileBins, &job->tileFrameBuffer);            // Render command into tile
             gpu_end_frame(vdp->gpuState, &gpuInstance);
 
+#ifdef VDP1_TILE_UNIFORM_ATTR
+            // check slice attr while hot in cache, uniform planes are sent as single value
+            uint32_t attrCnt = sizeof(tileCmdOut->attr) / VDP1_TILE_SLICE_CNT;
+            job->attrValue = job->tileFrameBuffer.attr[0];
+            job->attrUniform = memcmp(job->tileFrameBuffer.attr, job->tileFrameBuffer.attr + 1, attrCnt - 1) == 0;
+#endif
+
             //picocom_sleep_ms(10);
             //END_PROFILE();
             //printf("\tvdp1_render_tile_job[%d] took: %d us (%d ms)\n", coreId, t1-t0, (t1-t0)/1000); 
@@ -198,15 +257,19 @@ static void vdp1_render_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct til
 
         struct GpuInstance_t gpuInstance;
         gpu_init_instance(vdp->gpuState, &gpuInstance, coreId);
+        gpuInstance.subTileId = job->subTileId;
+        gpuInstance.trustedCmds = job->cmdListTrusted;
+        gpuInstance.enableProfiler = vdp->profilerEnabled;
+        gpuInstance.frameProfile = &vdp->coreProfile[coreId];
 
         BUS_INIT_CMD_PTR(tileCmdOut, EBusCmd_VDP2_TileFrameBuffer8bpp);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Waddress-of-packed-member"        
-        job->tileFrameBuffer.pixelsData = tileCmdOut->pixels + ( job->subTileId ?  (FRAME_W*(FRAME_TILE_SZ_Y / 2)) : 0 );        
+        job->tileFrameBuffer.pixelsData = tileCmdOut->pixels + (FRAME_W * VDP1_TILE_SLICE_SZ_Y * job->subTileId);        
         job->tileFrameBuffer.w = FRAME_W;
-        job->tileFrameBuffer.h = FRAME_TILE_SZ_Y / 2;
+        job->tileFrameBuffer.h = VDP1_TILE_SLICE_SZ_Y;
         job->tileFrameBuffer.tileId = tileId;
-        job->tileFrameBuffer.y = (tileId * FRAME_TILE_SZ_Y) + (job->subTileId * (FRAME_TILE_SZ_Y / 2));
+        job->tileFrameBuffer.y = (tileId * FRAME_TILE_SZ_Y) + (job->subTileId * VDP1_TILE_SLICE_SZ_Y);
         job->tileFrameBuffer.colorDepth = EColorDepth_8BPP;
 #pragma GCC diagnostic pop  
 
@@ -239,12 +302,12 @@ static void vdp1_render_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct til
             uint32_t tileRenderStartTime = picocom_time_us_32();
 
             // run job in core1 ( in parallel with core 2 )
-            memset( job->tileFrameBuffer.pixelsData, 0, sizeof(tileCmdOut->pixels) / 2);    
+            memset( job->tileFrameBuffer.pixelsData, 0, sizeof(tileCmdOut->pixels) / VDP1_TILE_SLICE_CNT);    
             
             // render gpu cmds                
             gpu_clear_error_stats(vdp->gpuState, &gpuInstance);
             gpu_begin_frame(vdp->gpuState, &gpuInstance, cmd->cmdSeqNum);
-            gpu_run_tile(vdp->gpuState, &gpuInstance, (GpuCommandList_t*)&cmdList, &job->tileFrameBuffer);            // Render command into tile
+            gpu_run_tile_binned(vdp->gpuState, &gpuInstance, (GpuCommandList_t*)&cmdList, job->tileBins, &job->tileFrameBuffer);            // Render command into tile
             gpu_end_frame(vdp->gpuState, &gpuInstance);
 
             //picocom_sleep_ms(10);
@@ -272,6 +335,59 @@ static void vdp1_render_tile_job(struct vdp1_t* vdp, uint32_t coreId, struct til
 
 
 
+#ifdef VDP1_DIRTY_TILE_TRACKING
+static bool vdp1_try_reuse_tile(struct vdp1_t* vdp, const struct VDP1CMD_DrawCmdData* cmd, GpuCommandList_t* cmdList, uint32_t tileId)
+{
+    if((cmd->cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_WriteVDP2Tile) == 0)
+        return false;
+
+    // hash tile cmds & output state
+    uint32_t seed = cmd->colorDepth | (cmd->defaultBlendMode << 8) | (cmd->globalVdp2PalBufferId << 16);
+    uint32_t hash = gpu_hash_tile_cmds(vdp->gpuState, cmdList, &vdp->tileBins, tileId, seed);
+
+    // only first pass of single pass tiles, vdp2 cmds may ref vdp2 buffers
+    bool canReuse = cmd->passId == 0 
+        && cmd->vdp2CmdDataCount == 0
+        && !vdp->vdp2BackgroundActive
+        && vdp->tileFramePacketCnt[tileId] == 0 
+        && vdp->tilePrevFramePacketCnt[tileId] == 1 
+        && vdp->tileHash[tileId] == hash;
+
+    if(vdp->tileFramePacketCnt[tileId] == 0)
+        vdp->tileHash[tileId] = hash;
+    if(vdp->tileFramePacketCnt[tileId] < 0xff)
+        vdp->tileFramePacketCnt[tileId]++;
+
+    if(!canReuse)
+        return false;
+
+    // send reuse in tile buffer
+    vdp1_wait_tile_cmd_out(vdp, vdp->currentTileCmdId);
+
+    struct VDP2CMD_ReuseTile* tileCmdOut = (struct VDP2CMD_ReuseTile*)vdp->tileCmdOut[ vdp->currentTileCmdId ];
+    BUS_INIT_CMD_PTR(tileCmdOut, EBusCmd_VDP2_ReuseTile);
+    tileCmdOut->tileId = tileId;
+    tileCmdOut->cmdSeqNum = cmd->cmdSeqNum;
+    tileCmdOut->cmdFlags = 0;
+
+    // handle flip on last tile ( dont allow flipping between tiles)
+    if(tileId == FRAME_TILE_CNT_Y-1)
+        tileCmdOut->cmdFlags = cmd->cmdFlags & (EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay | EVDP1CMD_DrawCmdData_completeFlags_CopyFB);
+
+    struct tileListJob_t* job = &vdp->jobs[0];    
+    memset(job, 0, sizeof(struct tileListJob_t));
+    vdp1_send_tile_cmd_async(vdp, job, &tileCmdOut->header, sizeof(*tileCmdOut));
+
+    vdp->currentTileCmdId++;
+    if(vdp->currentTileCmdId > 1)
+        vdp->currentTileCmdId = 0;
+
+    vdp->tileReuseCnt++;
+    return true;
+}
+#endif
+
+
 void vdp1_core2_main() 
 {
     // wait on job queue
@@ -350,6 +466,7 @@ static void app_handler_main(struct BusRx_t* bus, struct Cmd_Header_t* frame)
         // get create tile buffer for gpu
         uint32_t cmdErrors = 0;
         uint32_t tileBusCopyTotalTime = 0;
+        uint32_t tileBusBytesSaved = 0;
         uint32_t tileRenderTotalTime = 0;
 
         switch (cmd->colorDepth)
@@ -357,111 +474,121 @@ static void app_handler_main(struct BusRx_t* bus, struct Cmd_Header_t* frame)
         case EColorDepth_BGR565:
         case EColorDepth_8BPP:
         {
-#ifdef VDP1_MULTICORE_RENDER
+            struct GpuCommandList_t cmdList = {0};
+            cmdList.headerSz = 0;
+            cmdList.allocSz = cmd->header.sz;
+            cmdList.offset = 0;
+            cmdList.cmdCount = cmd->cmdDataCount; 
+            cmdList.cmdData = (uint8_t*)cmd->cmdData; // no const
+
+            // bin cmds by tile once, tile jobs only walk overlapping cmds
+            if(cmd->cmdDataCount > 0)
+                gpu_build_tile_bins(&cmdList, &vdp->tileBins, FRAME_TILE_CNT_Y);
+
+            // validate cmds & buffer refs once, tile jobs skip per cmd checks
+            bool cmdListTrusted = cmd->cmdDataCount > 0 && gpu_trust_cmds_list(vdp->gpuState, &cmdList);
+
+            // refresh caches tiles read ( eg. resolved autotiles ), before any slice runs
+            if(cmd->cmdDataCount > 0)
+                gpu_prepare_cmds_list(vdp->gpuState, &cmdList);
+
             if(cmd->cmdDataCount > 0)
             {    
-                // render striped on 2 cores
                 for(int i=0;i<FRAME_TILE_CNT_Y;i++)
                 {
                     if( (cmd->tileMask & (1 << i)) == 0 )
                         continue;               
 
-                    struct tileListJob_t* job0 = &vdp->job0;    
-
-                    memset(job0, 0, sizeof(struct tileListJob_t));
-                    job0->tileId = i;
-                    job0->subTileId = 0; 
-                    job0->cmdIn = cmd;
-                    job0->tileCmdOut = vdp->tileCmdOut[ vdp->currentTileCmdId ];
+#ifdef VDP1_DIRTY_TILE_TRACKING
+                    // tile unchanged, vdp2 keeps last frame
+                    if(vdp1_try_reuse_tile(vdp, cmd, &cmdList, i))
+                        continue;
+#endif
 
-                    struct tileListJob_t* job1 = &vdp->job1;    
+                    // wait buffer sent from 2 tiles ago
+                    vdp1_wait_tile_cmd_out(vdp, vdp->currentTileCmdId);
 
-                    memset(job1, 0, sizeof(struct tileListJob_t));
-                    job1->tileId = i;
-                    job1->subTileId = 1;
-                    job1->cmdIn = cmd;
-                    job1->tileCmdOut = vdp->tileCmdOut[ vdp->currentTileCmdId ];
+                    for(int j=0;j<VDP1_TILE_SLICE_CNT;j++)
+                    {
+                        struct tileListJob_t* job = &vdp->jobs[j];    
 
-                    // run job 2 on core 2 while inline render job 1
-                    queue_entry_t entry = {.job=job1};
-                    queue_add_blocking(&vdp->jobQueue, &entry);                
+                        memset(job, 0, sizeof(struct tileListJob_t));
+                        job->tileId = i;
+                        job->subTileId = j; 
+                        job->cmdIn = cmd;
+                        job->tileBins = &vdp->tileBins;
+                        job->cmdListTrusted = cmdListTrusted;
+                        job->tileCmdOut = vdp->tileCmdOut[ vdp->currentTileCmdId ];
+                    }
 
-                    // render
-                    vdp1_render_tile_job(g_vdp1, 0, job0);
-                    //vdp1_render_tile_job(g_vdp1, 1, job1); // inline render on this core
+#ifdef VDP1_MULTICORE_RENDER
+                    // queue all slices, both cores pull slices until tile done so uneven slices balance
+                    for(int j=0;j<VDP1_TILE_SLICE_CNT;j++)
+                    {
+                        queue_entry_t entry = {.job=&vdp->jobs[j]};
+                        queue_add_blocking(&vdp->jobQueue, &entry);                
+                    }
+
+                    uint32_t completeCnt = 0;
+                    queue_entry_t entry = {.job=0};
+                    while(queue_try_remove(&vdp->jobQueue, &entry))
+                    {
+                        vdp1_render_tile_job(g_vdp1, 0, entry.job);
+                        completeCnt++;
+                    }
+
+                    // wait slices on core 2
+                    while(completeCnt < VDP1_TILE_SLICE_CNT)
+                    {
+                        queue_remove_blocking(&vdp->completeQueue, &entry);    
+                        completeCnt++;
+                    }
+#else
+                    for(int j=0;j<VDP1_TILE_SLICE_CNT;j++)
+                        vdp1_render_tile_job(g_vdp1, 0, &vdp->jobs[j]);
+#endif
 
                     // add stats
-                    cmdErrors += job0->cmdErrors;                
-                    tileRenderTotalTime += job0->tileRenderTookTime;
-                    tileBusCopyTotalTime += job0->tileBusCopyTookTime;               
+                    for(int j=0;j<VDP1_TILE_SLICE_CNT;j++)
+                    {
+                        cmdErrors += vdp->jobs[j].cmdErrors;                
+                        tileRenderTotalTime += vdp->jobs[j].tileRenderTookTime;
+                    }
 
-                    queue_entry_t result = {.job=0};
-                    queue_remove_blocking(&vdp->completeQueue, &result);    
-                    assert(result.job == job1);
-                    
-                    if( (cmd->tileMask & (1 << job0->tileId)) != 0 )
-                        vdp1_send_tile_job(g_vdp1, 0, job0);    
+                    // slices share tile out, send once
+                    vdp1_send_tile_job(g_vdp1, 0, &vdp->jobs[0]);    
+                    tileBusCopyTotalTime += vdp->jobs[0].tileBusCopyTookTime;
+                    tileBusBytesSaved += vdp->jobs[0].tileBusBytesSaved;
 
                     // next buffer while sending
                     vdp->currentTileCmdId++;
                     if(vdp->currentTileCmdId > 1)
                         vdp->currentTileCmdId = 0;
-
-                    // add stats
-                    cmdErrors += job1->cmdErrors;                
-                    tileRenderTotalTime += job1->tileRenderTookTime;
-                    tileBusCopyTotalTime += job1->tileBusCopyTookTime;               
                 }                
             }
-#else
-            if(cmd->cmdDataCount > 0)
-            {    
-                for(int i=0;i<FRAME_TILE_CNT_Y;i++)
-                {
-                    if( (cmd->tileMask & (1 << i)) == 0 )
-                        continue;               
-
-                    struct tileListJob_t* job0 = &vdp->job0;    
 
-                    memset(job0, 0, sizeof(struct tileListJob_t));
-                    job0->tileId = i;
-                    job0->subTileId = 0; 
-                    job0->cmdIn = cmd;
-                    job0->tileCmdOut = vdp->tileCmdOut[ vdp->currentTileCmdId ];
-
-                    struct tileListJob_t* job1 = &vdp->job1;    
-
-                    memset(job1, 0, sizeof(struct tileListJob_t));
-                    job1->tileId = i;
-                    job1->subTileId = 1;
-                    job1->cmdIn = cmd;
-                    job1->tileCmdOut = vdp->tileCmdOut[ vdp->currentTileCmdId ];
-                    
-                    // render
-                    vdp1_render_tile_job(g_vdp1, 0, job0);
-                    vdp1_render_tile_job(g_vdp1, 1, job1); // inline render on this core
-
-                    // add stats
-                    cmdErrors += job0->cmdErrors;                
-                    tileRenderTotalTime += job0->tileRenderTookTime;
-                    tileBusCopyTotalTime += job0->tileBusCopyTookTime;               
-
-                    if( (cmd->tileMask & (1 << job1->tileId)) != 0 )
-                        vdp1_send_tile_job(g_vdp1, 0, job1);    
-
-                    if( (cmd->tileMask & (0 << job0->tileId)) != 0 )
-                        vdp1_send_tile_job(g_vdp1, 0, job0);    
+            // core profiles into frame profile, published on frame end
+            if(vdp->profilerEnabled)
+            {
+                for(int i=0;i<NUM_ELEMS(vdp->coreProfile);i++)
+                {
+                    gpu_profile_merge(&vdp->frameProfile, &vdp->coreProfile[i]);
+                    memset(&vdp->coreProfile[i], 0, sizeof(vdp->coreProfile[i]));
+                }
 
-                    // next buffer while sending
-                    vdp->currentTileCmdId++;
-                    if(vdp->currentTileCmdId > 1)
-                        vdp->currentTileCmdId = 0;
+                if(cmd->cmdFlags & (EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay | EVDP1CMD_DrawCmdData_completeFlags_CopyFB))
+                {
+                    vdp->lastFrameProfile = vdp->frameProfile;
+                    memset(&vdp->frameProfile, 0, sizeof(vdp->frameProfile));
+                }
+            }
 
-                    // add stats
-                    cmdErrors += job1->cmdErrors;                
-                    tileRenderTotalTime += job1->tileRenderTookTime;
-                    tileBusCopyTotalTime += job1->tileBusCopyTookTime;               
-                }                
+#ifdef VDP1_DIRTY_TILE_TRACKING
+            // frame end, tiles with single packet can be reused next frame
+            if(cmd->cmdFlags & (EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay | EVDP1CMD_DrawCmdData_completeFlags_CopyFB))
+            {
+                memcpy(vdp->tilePrevFramePacketCnt, vdp->tileFramePacketCnt, sizeof(vdp->tilePrevFramePacketCnt));
+                memset(vdp->tileFramePacketCnt, 0, sizeof(vdp->tileFramePacketCnt));
             }
 #endif
             break;
@@ -476,6 +603,7 @@ static void app_handler_main(struct BusRx_t* bus, struct Cmd_Header_t* frame)
         res.cmdSeqNum = cmd->cmdSeqNum;
         res.gpuErrors = cmdErrors;     
         res.tileBusCopyTotalTime = tileBusCopyTotalTime;  
+        res.tileBusBytesSaved = tileBusBytesSaved;
         res.tileRenderTotalTime = tileRenderTotalTime; 
         
         bus_tx_rpc_set_return_main(vdp->app_vlnk_tx, &res.header, &res.header);           
@@ -501,11 +629,34 @@ static void app_handler_main(struct BusRx_t* bus, struct Cmd_Header_t* frame)
         res.cmdSeqNum = cmd->cmdSeqNum;
         res.gpuErrors = 0;     
         res.tileBusCopyTotalTime = 0;
+        res.tileBusBytesSaved = 0;
         res.tileRenderTotalTime = 0; 
         
         bus_tx_rpc_set_return_main(vdp->app_vlnk_tx, &res.header, &res.header);           
         break;         
     }
+    case EBusCmd_VDP2_BackgroundDrawCmdList:
+    {
+        struct VDP2CMD_BackgroundDrawCmdList* cmd = (struct VDP2CMD_BackgroundDrawCmdList*)frame;
+
+        // forward in order with tiles, vdp2 latches on next frame start
+        bus_tx_wait(vdp->vdp2_vdbus_tx);  
+        bus_tx_write_async(vdp->vdp2_vdbus_tx, (uint8_t*)&cmd->header, cmd->header.sz);
+        bus_tx_wait(vdp->vdp2_vdbus_tx);
+
+#ifdef VDP1_DIRTY_TILE_TRACKING
+        // vdp2 pixels hold old background, no reuse next frame
+        vdp->vdp2BackgroundActive = cmd->drawCmdCnt > 0;
+        memset(vdp->tilePrevFramePacketCnt, 0, sizeof(vdp->tilePrevFramePacketCnt));
+#endif
+
+        static struct VDP2CMD_BackgroundDrawCmdListAck res = {};
+        BUS_INIT_CMD(res, EBusCmd_VDP2_BackgroundDrawCmdList);
+        res.drawCmdCnt = cmd->drawCmdCnt;
+
+        bus_tx_rpc_set_return_main(vdp->app_vlnk_tx, frame, &res.header);
+        break;         
+    }
     case EBusCmd_VDP1_GetStatus:
     {
         struct VDP1CMD_GetStatus* cmd = (struct VDP1CMD_GetStatus*)frame;
@@ -525,6 +676,39 @@ static void app_handler_main(struct BusRx_t* bus, struct Cmd_Header_t* frame)
         bus_tx_rpc_set_return_main(vdp->app_vlnk_tx, frame, &status.header);
         break;
     }    
+    case EBusCmd_VDP1_GetConfig:
+    case EBusCmd_VDP1_SetConfig:
+    {
+        struct VDP1CMD_Config* cmd = (struct VDP1CMD_Config*)frame;
+        if(frame->cmd == EBusCmd_VDP1_SetConfig && cmd->profilerEnabled != vdp->profilerEnabled)
+        {
+            // restart profile
+            vdp->profilerEnabled = cmd->profilerEnabled;
+            memset(vdp->coreProfile, 0, sizeof(vdp->coreProfile));
+            memset(&vdp->frameProfile, 0, sizeof(vdp->frameProfile));
+            memset(&vdp->lastFrameProfile, 0, sizeof(vdp->lastFrameProfile));
+        }
+        if(frame->cmd == EBusCmd_VDP1_SetConfig)
+            vdp->profilerLevel = cmd->profilerLevel;
+
+        static struct VDP1CMD_Config config = {};
+        BUS_INIT_CMD(config, frame->cmd);
+        config.profilerEnabled = vdp->profilerEnabled;
+        config.profilerLevel = vdp->profilerLevel;
+
+        bus_tx_rpc_set_return_main(vdp->app_vlnk_tx, frame, &config.header);
+        break;
+    }
+    case EBusCmd_VDP1_GpuProfileStats:
+    {
+        static struct VDP1CMD_GpuFrameProfile profile = {};
+        BUS_INIT_CMD(profile, EBusCmd_VDP1_GpuProfileStats);
+        profile.vdpId = 0;
+        profile.frameProfile = vdp->lastFrameProfile;
+
+        bus_tx_rpc_set_return_main(vdp->app_vlnk_tx, frame, &profile.header);
+        break;
+    }
     }
 }
 
@@ -558,6 +742,8 @@ int vdp1_init(struct vdp1_t* vdp, struct vdp1InitOptions_t* options)
 
     vdp->vdp2_vdbus_tx = options->vdp2_vdbus_tx;
     vdp->vdp2_vdbus_tx->tx_ack_timeout = 0;  // no timeout
+    vdp->vdp2_vdbus_tx->userData = vdp;
+    bus_tx_set_ack_callback(vdp->vdp2_vdbus_tx, vdp1_tile_sent_handler);
     vdp->vdp2_xlnk_rx = options->vdp2_xlnk_rx;    
     vdp->vdp2_xlnk_rx->userData = vdp;
 
@@ -569,8 +755,8 @@ int vdp1_init(struct vdp1_t* vdp, struct vdp1InitOptions_t* options)
     bus_rx_set_callback(vdp->vdp2_xlnk_rx, vdp2_handler_realtime, vdp2_handler_main);
 
     mutex_init(&vdp->sendLock);
-    queue_init(&vdp->jobQueue, sizeof(queue_entry_t), 2);
-    queue_init(&vdp->completeQueue, sizeof(queue_entry_t), 2);
+    queue_init(&vdp->jobQueue, sizeof(queue_entry_t), VDP1_TILE_SLICE_CNT);
+    queue_init(&vdp->completeQueue, sizeof(queue_entry_t), VDP1_TILE_SLICE_CNT);
 
     // alloc gpu
     vdp->gpuState = gpu_init(&options->gpuOptions);
@@ -592,6 +778,12 @@ int vdp1_init(struct vdp1_t* vdp, struct vdp1InitOptions_t* options)
             return SDKErr_Fail;
     }
 
+    // alloc tile bins
+    vdp->tileBins.cmdOffsetsCapacity = VDP1_TILE_BIN_MAX_ENTRIES;
+    vdp->tileBins.cmdOffsets = (uint16_t*)picocom_malloc(sizeof(uint16_t) * vdp->tileBins.cmdOffsetsCapacity);
+    if(!vdp->tileBins.cmdOffsets)
+        return SDKErr_Fail;
+
     return SDKErr_OK;
 }
 
@@ -6,6 +6,7 @@
 #include "platform/pico/bus/bus.h"
 #include "platform/pico/vdp1/hw_vdp1_types.h"
 #include "platform/pico/vdp2/hw_vdp2_types.h"
+#include "lib/components/vdp2_core/tile_codec.h"
 #ifdef PICOCOM_SDL
 #include "lib/components/mock_hardware/mutex.h"
 #else
@@ -17,6 +18,12 @@
 #ifndef PICOCOM_NATIVE_SIM
     #define VDP1_MULTICORE_RENDER               // Multi core dispatch VDP tile renderer
 #endif    
+#define VDP1_DIRTY_TILE_TRACKING                // Skip render & send of tiles unchanged since last frame
+#define VDP1_TILE_COMPRESSION                   // Run length encode 16bpp tiles before send, raw when wont pay off
+#define VDP1_TILE_UNIFORM_ATTR                  // Send uniform or unused 16bpp attr plane as single value
+#define VDP1_TILE_SLICE_CNT 4                   // Render jobs per tile, pulled by either core to balance uneven tiles
+#define VDP1_TILE_SLICE_SZ_Y (FRAME_TILE_SZ_Y / VDP1_TILE_SLICE_CNT)
+#define VDP1_TILE_BIN_MAX_ENTRIES ((DISPLAY_GPU_CMD_BUS_MAX_PACKET_SZ / sizeof(GpuCmd_Header)) * FRAME_TILE_CNT_Y)   // Worst case every cmd in every tile
 
 
 /** VDP1 init options */
@@ -41,8 +48,10 @@ typedef struct vdp1MainLoopOptions_t
 typedef struct tileListJob_t
 {
     uint32_t tileId;    
-    uint32_t subTileId;    
+    uint32_t subTileId;                             // slice within tile    
     const struct VDP1CMD_DrawCmdData* cmdIn;        // copy of draw cmd    
+    const struct GpuTileBins_t* tileBins;           // cmdIn binned by tile
+    bool cmdListTrusted;                            // cmdIn passed gpu_trust_cmds_list
 
     struct TileFrameBuffer_t tileFrameBuffer;         // gpu target buffer
 
@@ -51,6 +60,9 @@ typedef struct tileListJob_t
     uint32_t cmdErrors;
     uint32_t tileRenderTookTime;
     uint32_t tileBusCopyTookTime;
+    uint32_t tileBusBytesSaved;
+    bool attrUniform;                               // slice attr all attrValue
+    uint8_t attrValue;
 } tileListJob_t;
 
 
@@ -80,11 +92,29 @@ typedef struct vdp1_t
     queue_t jobQueue;
     queue_t completeQueue;
 
-    struct tileListJob_t job0;
-    struct tileListJob_t job1;
+    struct tileListJob_t jobs[VDP1_TILE_SLICE_CNT];   // tile slice jobs
 
     struct Cmd_Header_t* tileCmdOut[2];      // output vdp2 command with buffer   
+    volatile bool tileCmdOutInFlight[2];     // tileCmdOut being sent to vdp2, released on bus ack
     uint32_t currentTileCmdId;
+
+    struct GpuTileBins_t tileBins;           // Per tile cmd index of current draw cmd
+
+    // Dirty tile tracking, unchanged tiles reuse vdp2 pixels
+    uint32_t tileHash[FRAME_TILE_CNT_Y];                 // Cmd hash of first packet per tile
+    uint8_t tileFramePacketCnt[FRAME_TILE_CNT_Y];        // Packets per tile this frame
+    uint8_t tilePrevFramePacketCnt[FRAME_TILE_CNT_Y];    // Packets per tile last frame, reuse only valid when tile was single packet
+    uint32_t tileReuseCnt;                               // stat
+    bool vdp2BackgroundActive;                           // Vdp2 background layers change under unchanged tiles, disables reuse
+
+    uint16_t tileCodecCtrl[TILE_CODEC_MAX_CTRL*2];       // Pixel & attr ctrl stream scratch
+
+    // Profiler, enabled with EBusCmd_VDP1_SetConfig
+    bool profilerEnabled;
+    uint32_t profilerLevel;
+    struct GpuFrameProfile coreProfile[2];          // Per core tile job profile of current draw cmd
+    struct GpuFrameProfile frameProfile;            // Draw cmds accumulated until frame flip
+    struct GpuFrameProfile lastFrameProfile;        // Last complete frame, returned by EBusCmd_VDP1_GpuProfileStats
 } vdp1_t;
 
 
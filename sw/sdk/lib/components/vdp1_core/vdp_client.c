@@ -73,6 +73,7 @@ static void vdp1_handler_main(struct BusRx_t* bus, struct Cmd_Header_t* frame)
                         // stats
                         client->tileBusCopyTotalTime += cmd->tileBusCopyTotalTime;
                         client->tileRenderTotalTime += cmd->tileRenderTotalTime;
+                        client->tileBusBytesSaved += cmd->tileBusBytesSaved;
                     }
                 }
             }
@@ -129,6 +130,21 @@ struct VdpClientImpl_t* vdp1_client_init(struct VdpClientInitOptions_t* options)
             return 0;             
     }
 
+    // overflow bins, needs room for at least 2 lists so the current list can always be spilled
+    if(options->overflowBinAllocSize)
+    {
+        if(options->overflowBinAllocSize < options->cmdListAllocSize * 2)
+            return 0;
+
+        client->overflowBinData = (uint8_t*)picocom_malloc(options->overflowBinAllocSize);
+        if(!client->overflowBinData)
+            return 0;
+        client->overflowVdp2Data = (uint8_t*)picocom_malloc(VDP2_TILE_CMD_DATA_SZ);
+        if(!client->overflowVdp2Data)
+            return 0;
+        client->overflowBinAllocSize = options->overflowBinAllocSize;
+    }
+
     client->maxCmdSize = options->cmdListAllocSize - sizeof(struct VDP1CMD_DrawCmdData);
     client->vdp1Link_tx = options->vdp1Link_tx;
     client->vdp1Link_rx = options->vdp1Link_rx;
@@ -166,6 +182,58 @@ int vdp1_client_get_status(struct VdpClientImpl_t* client, struct VDP1CMD_GetSta
 }
 
 
+int vdp1_client_get_frame_profile(struct VdpClientImpl_t* client, struct VDP1CMD_GpuFrameProfile* profileOut)
+{
+    // blocking profile query    
+    int res;
+    struct VDP1CMD_GpuFrameProfile profileCmd = {};    
+    BUS_INIT_CMD(profileCmd, EBusCmd_VDP1_GpuProfileStats);
+#ifdef PICOCOM_NATIVE_SIM    
+    res = bus_tx_request_blocking_ex(client->vdp1Link_tx, client->vdp1Link_rx, &profileCmd.header, &profileOut->header, sizeof(*profileOut), 10000, test_service_vdp1_main, 0 );
+#else
+    res = bus_tx_request_blocking_ex(client->vdp1Link_tx, client->vdp1Link_rx, &profileCmd.header, &profileOut->header, sizeof(*profileOut), 10000, 0, 0 );    
+#endif
+    if(res != SDKErr_OK)
+    {
+        return SDKErr_Fail;
+    }
+
+    return SDKErr_OK;
+}
+
+
+int vdp1_client_set_vdp2_background(struct VdpClientImpl_t* client, const struct GpuCommandList_t* cmdList)
+{
+    // null or empty list disables background
+    uint32_t dataSz = cmdList ? cmdList->offset - cmdList->headerSz : 0;
+    if(dataSz > VDP2_BG_CMD_DATA_SZ)
+        return SDKErr_Fail;
+
+    // blocking forward, flushes queued draw cmds first so vdp2 sees it in frame order
+    int res;
+    struct VDP2CMD_BackgroundDrawCmdList bgCmd = {};
+    BUS_INIT_CMD(bgCmd, EBusCmd_VDP2_BackgroundDrawCmdList);
+    bgCmd.drawCmdCnt = dataSz ? cmdList->cmdCount : 0;
+    bgCmd.drawCmdDataSz = dataSz;
+    if(dataSz)
+        memcpy(bgCmd.drawCmdData, cmdList->cmdData + cmdList->headerSz, dataSz);
+    bgCmd.header.sz = sizeof(bgCmd) - VDP2_BG_CMD_DATA_SZ + dataSz;     // trim unused cmd data
+
+    struct VDP2CMD_BackgroundDrawCmdListAck ack = {};
+#ifdef PICOCOM_NATIVE_SIM    
+    res = bus_tx_request_blocking_ex(client->vdp1Link_tx, client->vdp1Link_rx, &bgCmd.header, &ack.header, sizeof(ack), 10000, test_service_vdp1_main, 0 );
+#else
+    res = bus_tx_request_blocking_ex(client->vdp1Link_tx, client->vdp1Link_rx, &bgCmd.header, &ack.header, sizeof(ack), 10000, 0, 0 );    
+#endif
+    if(res != SDKErr_OK || ack.drawCmdCnt != bgCmd.drawCmdCnt)
+    {
+        return SDKErr_Fail;
+    }
+
+    return SDKErr_OK;
+}
+
+
 int vdp1_client_wait_free(struct VdpClientImpl_t* client)
 {
     while(client->freeCmdLists.count <= 0)
@@ -377,8 +445,11 @@ int vdp1_begin_frame(struct VdpClientImpl_t* client, uint16_t tileMask, uint32_t
     client->current_tileMask = tileMask;
     client->current_cmdFlags = cmdFlags;
     client->pendingCmdBufferOverflowCnt = 0;
+    client->overflowBinOffset = 0;
+    client->overflowBinCmdCount = 0;
     client->tileBusCopyTotalTime = 0;
     client->tileRenderTotalTime = 0;
+    client->tileBusBytesSaved = 0;
     client->autoFlush_cmdFlag = EVDP1CMD_DrawCmdData_completeFlags_WriteVDP2Tile;
     client->colorDepth = EColorDepth_BGR565;
     
@@ -386,6 +457,208 @@ int vdp1_begin_frame(struct VdpClientImpl_t* client, uint16_t tileMask, uint32_t
 }
 
 
+/** Move cmds in req list to overflow bins, list is cleared ( vdp2 section kept ) */
+static bool vdp1_client_spill_cmd_list(struct VdpClientImpl_t* client, struct VdpPendingVDPCmd_t* req)
+{
+    struct GpuCommandList_t* cmdList = req->cmdList;
+    uint32_t sz = cmdList->offset - cmdList->headerSz;
+    if(client->overflowBinOffset + sz > client->overflowBinAllocSize)
+        return false;
+
+    memcpy(client->overflowBinData + client->overflowBinOffset, cmdList->cmdData + cmdList->headerSz, sz);
+    client->overflowBinOffset += sz;
+    client->overflowBinCmdCount += cmdList->cmdCount;
+    gpu_cmd_list_clear(cmdList);
+    return true;
+}
+
+
+/** Size of spilled cmds rendered into any tile in bandMask */
+static uint32_t vdp1_client_calc_overflow_bin_sz(struct VdpClientImpl_t* client, uint16_t bandMask)
+{
+    uint16_t allBands = (1 << FRAME_TILE_CNT_Y) - 1;
+    uint32_t sz = 0;
+    uint32_t i = 0;
+    for(int index=0;index<client->overflowBinCmdCount;index++)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)(client->overflowBinData + i);
+        if(gpu_calc_cmd_tile_mask(header, allBands) & bandMask)
+            sz += header->sz;
+        i += header->sz;
+    }
+    return sz;
+}
+
+
+/** Get next packet for binned commit, first packet re-uses current req. VDP2 cmds copied from prev packet */
+static struct VdpPendingVDPCmd_t* vdp1_client_next_overflow_packet(struct VdpClientImpl_t* client, struct VdpPendingVDPCmd_t* prev)
+{
+    // prev list may be recycled by wait free, hold its vdp2 section until req is ready
+    struct VDP1CMD_DrawCmdData* prevOut = (VDP1CMD_DrawCmdData*)prev->cmdList->cmdData;
+    uint16_t vdp2CmdCount = prev->refVdp2CmdList.cmdCount;
+    uint32_t vdp2CmdSz = prev->refVdp2CmdList.offset;
+    memcpy(client->overflowVdp2Data, prevOut->vdp2CmdData, vdp2CmdSz);
+
+    vdp1_client_wait_free(client);
+    struct VdpPendingVDPCmd_t* req = vdp1_client_begin_cmd_list( client );
+    if(!req)
+        return 0;
+
+    struct VDP1CMD_DrawCmdData* cmdOut = (VDP1CMD_DrawCmdData*)req->cmdList->cmdData;
+    memcpy(cmdOut->vdp2CmdData, client->overflowVdp2Data, vdp2CmdSz);
+    req->refVdp2CmdList.cmdCount = vdp2CmdCount;
+    req->refVdp2CmdList.offset = vdp2CmdSz;
+    return req;
+}
+
+
+/** Commit spilled & current cmds packed by tile band, bands are rendered and sent to vdp2 once unless a 
+ * single band overflows a packet which is then split into passes. Returns last committed req.
+*/
+static struct VdpPendingVDPCmd_t* vdp1_client_commit_overflow_bins(struct VdpClientImpl_t* client, struct VdpPendingVDPCmd_t* req, uint16_t tileMask, uint32_t cmdFlags, uint32_t* passCntOut)
+{
+    // current list always fits, bins keep room for 1 list
+    vdp1_client_spill_cmd_list(client, req);
+
+    uint16_t allBands = (1 << FRAME_TILE_CNT_Y) - 1;
+    uint16_t bandsLeft = tileMask & allBands;
+    uint32_t passId = req->passId;
+    uint32_t passCnt = 1;
+    uint32_t capacity = req->cmdList->allocSz - req->cmdList->headerSz - 1; // gpu_cmd_list_can_add
+    struct VdpPendingVDPCmd_t* out = req;
+    bool outCommitted = false;
+
+    client->overflowBinPacketCnt = 0;
+
+    while(bandsLeft)
+    {
+        int band = 0;
+        while(!(bandsLeft & (1 << band)))
+            band++;
+
+        // grow band group while cmds fit a packet
+        uint16_t group = 0;
+        for(int i=band;i<FRAME_TILE_CNT_Y;i++)
+        {
+            if(!(bandsLeft & (1 << i)))
+                continue;
+            uint16_t candidate = group | (1 << i);
+            if(vdp1_client_calc_overflow_bin_sz(client, candidate) > capacity)
+                break;
+            group = candidate;
+        }
+
+        // band alone overflows, split into passes
+        bool splitBand = group == 0;
+        if(splitBand)
+            group = 1 << band;
+
+        if(outCommitted)
+        {
+            out = vdp1_client_next_overflow_packet(client, out);
+            if(!out)
+                return 0;
+        }
+        out->passId = passId;
+        outCommitted = false;
+
+        uint32_t i = 0;
+        for(int index=0;index<client->overflowBinCmdCount;index++)
+        {
+            GpuCmd_Header* header = (GpuCmd_Header*)(client->overflowBinData + i);
+            i += header->sz;
+            if(!(gpu_calc_cmd_tile_mask(header, allBands) & group))
+                continue;
+
+            if(!gpu_cmd_list_can_add(out->cmdList, header->sz))
+            {
+                // next pass for split band
+                vdp1_client_commit_cmd_list(client, out, group, client->autoFlush_cmdFlag);
+                client->overflowBinPacketCnt++;
+                vdp1_update_queue(client);
+
+                out = vdp1_client_next_overflow_packet(client, out);
+                if(!out)
+                    return 0;
+                out->passId = ++passId;
+                passCnt = MAX(passCnt, passId - req->passId + 1);
+            }
+
+            GpuCmd_Header* dstCmd = gpu_cmd_list_add_next(out->cmdList, header->sz);
+            if(dstCmd)
+                memcpy(dstCmd, header, header->sz);
+        }
+
+        // frame end flags only on last packet, vdp1 runs frame end once
+        bandsLeft &= ~group;
+        vdp1_client_commit_cmd_list(client, out, group, bandsLeft ? client->autoFlush_cmdFlag : cmdFlags);
+        client->overflowBinPacketCnt++;
+        vdp1_update_queue(client);
+        outCommitted = true;
+
+        passId = req->passId;
+    }
+
+    // nothing to render, send empty packet for completion
+    if(!outCommitted)
+    {
+        vdp1_client_commit_cmd_list(client, out, 0, cmdFlags);
+        client->overflowBinPacketCnt++;
+    }
+
+    client->overflowBinOffset = 0;
+    client->overflowBinCmdCount = 0;
+    if(passCntOut)
+        *passCntOut = passCnt;
+    return out;
+}
+
+
+/** Forward spilled & current cmds to vdp2 in submit order, vdp2 section & frame flags are sent with the last packet. Returns last committed req. */
+static struct VdpPendingVDPCmd_t* vdp1_client_forward_overflow_bins(struct VdpClientImpl_t* client, struct VdpPendingVDPCmd_t* req, uint16_t tileMask, uint32_t cmdFlags)
+{
+    // current list always fits, bins keep room for 1 list
+    vdp1_client_spill_cmd_list(client, req);
+
+    struct VdpPendingVDPCmd_t* out = req;
+    uint32_t i = 0;
+    for(int index=0;index<client->overflowBinCmdCount;index++)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)(client->overflowBinData + i);
+        i += header->sz;
+
+        if(!gpu_cmd_list_can_add(out->cmdList, header->sz))
+        {
+            // vdp2 section held back for last packet
+            uint16_t vdp2CmdCount = out->refVdp2CmdList.cmdCount;
+            uint32_t vdp2CmdSz = out->refVdp2CmdList.offset;
+            out->refVdp2CmdList.cmdCount = 0;
+            out->refVdp2CmdList.offset = 0;
+            vdp1_client_commit_cmd_list_to_vdp2(client, out, tileMask, client->autoFlush_cmdFlag);
+            vdp1_update_queue(client);
+            out->refVdp2CmdList.cmdCount = vdp2CmdCount;
+            out->refVdp2CmdList.offset = vdp2CmdSz;
+
+            out = vdp1_client_next_overflow_packet(client, out);
+            if(!out)
+                break;
+        }
+
+        GpuCmd_Header* dstCmd = gpu_cmd_list_add_next(out->cmdList, header->sz);
+        if(dstCmd)
+            memcpy(dstCmd, header, header->sz);
+    }
+
+    client->overflowBinOffset = 0;
+    client->overflowBinCmdCount = 0;
+    if(!out)
+        return 0;
+
+    vdp1_client_commit_cmd_list_to_vdp2(client, out, tileMask, cmdFlags);
+    return out;
+}
+
+
 GpuCmd_Header* vdp1_cmd_add_next(struct VdpClientImpl_t* client, uint8_t vdpIdSection, uint32_t sz)
 {
     return vdp1_cmd_add_next_impl( client, vdpIdSection, sz, true ); // allow flush by default
@@ -409,13 +682,31 @@ GpuCmd_Header* vdp1_cmd_add_next_impl(struct VdpClientImpl_t* client, uint8_t vd
                 if(!canFlush)
                     return 0;
 
-                vdp1_client_commit_cmd_list(client, cmdReq, client->current_tileMask, client->autoFlush_cmdFlag);
+                // spill to overflow bins, sent per band on end frame
+                if(client->overflowBinData && vdp1_client_spill_cmd_list(client, cmdReq))
+                {
+                    // keep room for current list
+                    if(client->overflowBinAllocSize - client->overflowBinOffset > cmdReq->cmdList->allocSz)
+                        return gpu_cmd_list_add_next(cmdReq->cmdList, sz);
+
+                    // bins full, flush as pass
+                    uint32_t passCnt = 0;
+                    cmdReq = vdp1_client_commit_overflow_bins(client, cmdReq, client->current_tileMask, client->autoFlush_cmdFlag, &passCnt);
+                    if(!cmdReq)
+                        return 0;
+                    vdp1_client_wait_completion(client, cmdReq, 0);
+                    client->pendingCmdBufferOverflowCnt += passCnt;
+                }
+                else
+                {
+                    vdp1_client_commit_cmd_list(client, cmdReq, client->current_tileMask, client->autoFlush_cmdFlag);
 
-                vdp1_update_queue(client);
+                    vdp1_update_queue(client);
 
-                vdp1_client_wait_completion(client, cmdReq, 0);
+                    vdp1_client_wait_completion(client, cmdReq, 0);
 
-                client->pendingCmdBufferOverflowCnt++;
+                    client->pendingCmdBufferOverflowCnt++;
+                }
             }
 
             // wait gpu buffer free after flush
@@ -469,7 +760,10 @@ int vdp1_end_frame(struct VdpClientImpl_t* client, bool waitCompletion, bool wri
     //printf("write tile %d, writeVDP2Tile: %d, passId: %d, cmdCount:  %d\n", cmdReq->cmdSeqNum, writeVDP2Tile, cmdReq->passId, cmdReq->refVdp2CmdList.cmdCount);
     if(cmdReq)
     {        
-        vdp1_client_commit_cmd_list(client, cmdReq, client->current_tileMask, client->current_cmdFlags);
+        if(client->overflowBinCmdCount > 0)
+            cmdReq = vdp1_client_commit_overflow_bins(client, cmdReq, client->current_tileMask, client->current_cmdFlags, 0);
+        else
+            vdp1_client_commit_cmd_list(client, cmdReq, client->current_tileMask, client->current_cmdFlags);
     }
 
     vdp1_update_queue(client);
@@ -503,7 +797,14 @@ int vdp1_end_frame_commit_to_vdp2(struct VdpClientImpl_t* client, bool waitCompl
     struct VdpPendingVDPCmd_t* cmdReq = client->currentPending;
     if(cmdReq)
     {        
-        vdp1_client_commit_cmd_list_to_vdp2(client, cmdReq, client->current_tileMask, client->current_cmdFlags);
+        if(client->overflowBinCmdCount > 0)
+        {
+            cmdReq = vdp1_client_forward_overflow_bins(client, cmdReq, client->current_tileMask, client->current_cmdFlags);
+            if(!cmdReq)
+                result = SDKErr_Fail;
+        }
+        else
+            vdp1_client_commit_cmd_list_to_vdp2(client, cmdReq, client->current_tileMask, client->current_cmdFlags);
     }
 
     vdp1_update_queue(client);
@@ -42,6 +42,7 @@ typedef struct VdpClientInitOptions_t {
     struct BusRx_t* vdp1Link_rx;        
     uint32_t cmdListPoolCnt;        // number of cmd lists to allow in flight
     uint32_t cmdListAllocSize;      // cmd list size sould match max bus packet    
+    uint32_t overflowBinAllocSize;  // frame spill buffer for cmd list overflow, 0 uses multi-pass flush
 } VdpClientInitOptions_t;
 
 
@@ -71,16 +72,27 @@ typedef struct VdpClientImpl_t
     // Frame stats (non profiling)
     uint32_t tileBusCopyTotalTime;      // stat for total copy time
     uint32_t tileRenderTotalTime;       // stat for tile render time client    
+    uint32_t tileBusBytesSaved;         // stat for bytes saved by tile compression
 
     uint32_t maxCmdSize;                // max possible gpu cmd
 
     uint8_t defaultVDP2CompBlendMode;   // Default vdp2 tile comp mode (defaults to alpha for for comping tiles with alpha data)
+
+    // Overflow binning, cmds spilled on list overflow are sent per tile band at end frame so each band renders once
+    uint8_t* overflowBinData;           // Spilled cmd data
+    uint32_t overflowBinAllocSize;
+    uint32_t overflowBinOffset;         // Spilled data size
+    uint16_t overflowBinCmdCount;       // Spilled cmd count
+    uint32_t overflowBinPacketCnt;      // stat, packets sent by last binned frame
+    uint8_t* overflowVdp2Data;          // VDP2 section of last packet, held while its list is recycled
 } VdpClientImpl_t;
 
 
 // VDP1 client core
 struct VdpClientImpl_t* vdp1_client_init(struct VdpClientInitOptions_t* options);
 int vdp1_client_get_status(struct VdpClientImpl_t* client, struct VDP1CMD_GetStatus* statusOut);
+int vdp1_client_get_frame_profile(struct VdpClientImpl_t* client, struct VDP1CMD_GpuFrameProfile* profileOut);  // Last complete vdp1 frame profile, requires profiler enabled
+int vdp1_client_set_vdp2_background(struct VdpClientImpl_t* client, const struct GpuCommandList_t* cmdList);  // Set vdp2 background layer cmds, latched on next frame, null disables
 int vdp1_client_wait_free(struct VdpClientImpl_t* client);
 struct VdpPendingVDPCmd_t* vdp1_client_begin_cmd_list(struct VdpClientImpl_t* client );
 int vdp1_client_commit_cmd_list(struct VdpClientImpl_t* client, struct VdpPendingVDPCmd_t* cmd, uint16_t tileMask, uint32_t cmdFlags);
@@ -0,0 +1,361 @@
+#include "tile_codec.h"
+#include <string.h>
+#include <stddef.h>
+
+
+//
+//
+int32_t tile_codec_encode_rle16(uint16_t* data, uint32_t cnt, uint16_t* ctrl, uint32_t maxCtrl, bool write, uint32_t* dataCntOut)
+{
+    uint32_t i = 0;
+    uint32_t o = 0;             // write index, never passes i
+    uint32_t ctrlCnt = 0;
+    uint32_t litStart = 0;
+    uint32_t litLen = 0;
+
+    while(i < cnt)
+    {
+        uint16_t v = data[i];
+        uint32_t run = 1;
+        while(i+run < cnt && data[i+run] == v && run < TILE_CODEC_MAX_LEN)
+            run++;
+
+        // literal, runs < 3 dont save
+        if(run < 3)
+        {
+            if(litLen == 0)
+                litStart = i;
+            litLen += run;
+            i += run;
+            if(litLen < TILE_CODEC_MAX_LEN - 2)
+                continue;
+        }
+
+        // flush literal
+        if(litLen)
+        {
+            if(ctrlCnt >= maxCtrl)
+                return -1;
+            ctrl[ctrlCnt++] = litLen;
+            if(write)
+                memmove(&data[o], &data[litStart], litLen * sizeof(uint16_t));
+            o += litLen;
+            litLen = 0;
+        }
+
+        if(run >= 3)
+        {
+            if(ctrlCnt >= maxCtrl)
+                return -1;
+            ctrl[ctrlCnt++] = TILE_CODEC_RUN_FLAG | run;
+            if(write)
+                data[o] = v;
+            o++;
+            i += run;
+        }
+    }
+
+    if(litLen)
+    {
+        if(ctrlCnt >= maxCtrl)
+            return -1;
+        ctrl[ctrlCnt++] = litLen;
+        if(write)
+            memmove(&data[o], &data[litStart], litLen * sizeof(uint16_t));
+        o += litLen;
+    }
+
+    *dataCntOut = o;
+    return ctrlCnt;
+}
+
+
+int32_t tile_codec_encode_rle8(uint8_t* data, uint32_t cnt, uint16_t* ctrl, uint32_t maxCtrl, bool write, uint32_t* dataCntOut)
+{
+    uint32_t i = 0;
+    uint32_t o = 0;             // write index, never passes i
+    uint32_t ctrlCnt = 0;
+    uint32_t litStart = 0;
+    uint32_t litLen = 0;
+
+    while(i < cnt)
+    {
+        uint8_t v = data[i];
+        uint32_t run = 1;
+        while(i+run < cnt && data[i+run] == v && run < TILE_CODEC_MAX_LEN)
+            run++;
+
+        // literal, runs < 4 dont save ( ctrl is 2 bytes )
+        if(run < 4)
+        {
+            if(litLen == 0)
+                litStart = i;
+            litLen += run;
+            i += run;
+            if(litLen < TILE_CODEC_MAX_LEN - 3)
+                continue;
+        }
+
+        // flush literal
+        if(litLen)
+        {
+            if(ctrlCnt >= maxCtrl)
+                return -1;
+            ctrl[ctrlCnt++] = litLen;
+            if(write)
+                memmove(&data[o], &data[litStart], litLen);
+            o += litLen;
+            litLen = 0;
+        }
+
+        if(run >= 4)
+        {
+            if(ctrlCnt >= maxCtrl)
+                return -1;
+            ctrl[ctrlCnt++] = TILE_CODEC_RUN_FLAG | run;
+            if(write)
+                data[o] = v;
+            o++;
+            i += run;
+        }
+    }
+
+    if(litLen)
+    {
+        if(ctrlCnt >= maxCtrl)
+            return -1;
+        ctrl[ctrlCnt++] = litLen;
+        if(write)
+            memmove(&data[o], &data[litStart], litLen);
+        o += litLen;
+    }
+
+    *dataCntOut = o;
+    return ctrlCnt;
+}
+
+
+bool tile_codec_decode_rle16(const uint16_t* ctrl, uint32_t ctrlCnt, const uint16_t* data, uint32_t dataCnt, uint16_t* out, uint32_t outCnt)
+{
+    uint32_t d = 0;
+    uint32_t o = 0;
+    for(int i=0;i<ctrlCnt;i++)
+    {
+        uint32_t len = ctrl[i] & TILE_CODEC_MAX_LEN;
+        if(o + len > outCnt)
+            return false;
+
+        if(ctrl[i] & TILE_CODEC_RUN_FLAG)
+        {
+            if(d >= dataCnt)
+                return false;
+            uint16_t v = data[d++];
+            for(int j=0;j<len;j++)
+                out[o++] = v;
+        }
+        else 
+        {
+            if(d + len > dataCnt)
+                return false;
+            memcpy(&out[o], &data[d], len * sizeof(uint16_t));
+            d += len;
+            o += len;
+        }
+    }
+    return o == outCnt && d == dataCnt;
+}
+
+
+bool tile_codec_decode_rle8(const uint16_t* ctrl, uint32_t ctrlCnt, const uint8_t* data, uint32_t dataCnt, uint8_t* out, uint32_t outCnt)
+{
+    uint32_t d = 0;
+    uint32_t o = 0;
+    for(int i=0;i<ctrlCnt;i++)
+    {
+        uint32_t len = ctrl[i] & TILE_CODEC_MAX_LEN;
+        if(o + len > outCnt)
+            return false;
+
+        if(ctrl[i] & TILE_CODEC_RUN_FLAG)
+        {
+            if(d >= dataCnt)
+                return false;
+            memset(&out[o], data[d++], len);
+            o += len;
+        }
+        else 
+        {
+            if(d + len > dataCnt)
+                return false;
+            memcpy(&out[o], &data[d], len);
+            d += len;
+            o += len;
+        }
+    }
+    return o == outCnt && d == dataCnt;
+}
+
+
+//
+//
+uint32_t tile_codec_compress_tile16bpp(struct VDP2CMD_TileFrameBuffer16bpp* cmd, uint16_t* ctrlScratch, uint32_t ctrlScratchCnt, bool encodePlanes, bool attrUniform)
+{
+    const uint32_t pixelCnt = NUM_ELEMS(cmd->pixels);
+    const uint32_t attrCnt = NUM_ELEMS(cmd->attr);
+    uint32_t maxCtrl = ctrlScratchCnt / 2;
+    uint16_t* pixelCtrl = ctrlScratch;
+    uint16_t* attrCtrl = ctrlScratch + maxCtrl;
+
+    if(cmd->vdp2CmdDataSz > sizeof(cmd->vdp2CmdData))
+        return 0;
+    if(!encodePlanes && !attrUniform)
+        return 0;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waddress-of-packed-member"
+    uint16_t* pixels = cmd->pixels;
+    uint8_t* attr = cmd->attr;
+#pragma GCC diagnostic pop
+
+    // size pass, nothing written so raw kept on fail
+    uint8_t flags = 0;
+    uint32_t pixelDataCnt = pixelCnt;
+    uint32_t attrDataCnt = attrCnt;
+    int32_t pixelCtrlCnt = -1;
+    int32_t attrCtrlCnt = -1;
+    if(encodePlanes)
+        pixelCtrlCnt = tile_codec_encode_rle16(pixels, pixelCnt, pixelCtrl, maxCtrl, false, &pixelDataCnt);
+    if(pixelCtrlCnt < 0)
+    {
+        flags |= TILE_CODEC_FLAG_RAW_PIXELS;
+        pixelCtrlCnt = 0;
+        pixelDataCnt = pixelCnt;
+    }
+
+    if(attrUniform)
+    {
+        flags |= TILE_CODEC_FLAG_UNIFORM_ATTR;
+        attrCtrlCnt = 0;
+        attrDataCnt = 1;
+    }
+    else
+    {
+        if(encodePlanes)
+            attrCtrlCnt = tile_codec_encode_rle8(attr, attrCnt, attrCtrl, maxCtrl, false, &attrDataCnt);
+        if(attrCtrlCnt < 0)
+        {
+            flags |= TILE_CODEC_FLAG_RAW_ATTR;
+            attrCtrlCnt = 0;
+            attrDataCnt = attrCnt;
+        }
+    }
+
+    uint32_t ctrlOffset = offsetof(VDP2CMD_TileFrameBuffer16bppRLE, pixels) + (pixelDataCnt * sizeof(uint16_t)) + attrDataCnt;
+    ctrlOffset = (ctrlOffset + 3) & ~3;
+    uint32_t vdp2CmdOffset = ctrlOffset + ((pixelCtrlCnt + attrCtrlCnt) * sizeof(uint16_t));
+    uint32_t trailerOffset = vdp2CmdOffset + cmd->vdp2CmdDataSz;
+    uint32_t sz = trailerOffset + sizeof(VDP2TileRLETrailer);
+
+    // must save at least 1/8th to pay for encode & decode
+    if(sz > sizeof(*cmd) - (sizeof(*cmd) / 8))
+        return 0;
+
+    VDP2TileRLETrailer trailer = {0};
+    trailer.passId = cmd->passId;
+    trailer.vdp2CmdDataSz = cmd->vdp2CmdDataSz;
+    trailer.vdp2CmdDataCount = cmd->vdp2CmdDataCount;
+    trailer.pixelCtrlCnt = pixelCtrlCnt;
+    trailer.pixelDataCnt = pixelDataCnt;
+    trailer.attrCtrlCnt = attrCtrlCnt;
+    trailer.attrDataCnt = attrDataCnt;
+    trailer.defaultBlendMode = cmd->defaultBlendMode;
+    trailer.flags = flags;
+
+    // encode planes in place, attr data packed after pixel data
+    uint8_t* packet = (uint8_t*)cmd;
+    uint8_t* attrDst = (uint8_t*)pixels + (pixelDataCnt * sizeof(uint16_t));
+    if((flags & TILE_CODEC_FLAG_RAW_PIXELS) == 0)
+        tile_codec_encode_rle16(pixels, pixelCnt, pixelCtrl, maxCtrl, true, &pixelDataCnt);
+    if(flags & TILE_CODEC_FLAG_UNIFORM_ATTR)
+        attrDst[0] = attr[0];
+    else
+    {
+        if((flags & TILE_CODEC_FLAG_RAW_ATTR) == 0)
+            tile_codec_encode_rle8(attr, attrCnt, attrCtrl, maxCtrl, true, &attrDataCnt);
+        memmove(attrDst, attr, attrDataCnt);
+    }
+
+    // vdp2 cmds first, ctrl & trailer may overlap its source
+    memmove(packet + vdp2CmdOffset, cmd->vdp2CmdData, trailer.vdp2CmdDataSz);
+    memcpy(packet + ctrlOffset, pixelCtrl, pixelCtrlCnt * sizeof(uint16_t));
+    memcpy(packet + ctrlOffset + (pixelCtrlCnt * sizeof(uint16_t)), attrCtrl, attrCtrlCnt * sizeof(uint16_t));
+    memcpy(packet + trailerOffset, &trailer, sizeof(trailer));
+
+    cmd->header.cmd = EBusCmd_VDP2_TileFrameBuffer16bppRLE;
+    cmd->header.sz = sz;
+    return sz;
+}
+
+
+bool tile_codec_decompress_tile16bpp(const struct VDP2CMD_TileFrameBuffer16bppRLE* cmd, struct VDP2CMD_TileFrameBuffer16bpp* out)
+{
+    const uint8_t* packet = (const uint8_t*)cmd;
+    uint32_t sz = cmd->header.sz;
+    if(sz < offsetof(VDP2CMD_TileFrameBuffer16bppRLE, pixels) + sizeof(VDP2TileRLETrailer))
+        return false;
+
+    VDP2TileRLETrailer trailer;
+    uint32_t trailerOffset = sz - sizeof(VDP2TileRLETrailer);
+    memcpy(&trailer, packet + trailerOffset, sizeof(trailer));
+
+    uint32_t ctrlOffset = offsetof(VDP2CMD_TileFrameBuffer16bppRLE, pixels) + (trailer.pixelDataCnt * sizeof(uint16_t)) + trailer.attrDataCnt;
+    ctrlOffset = (ctrlOffset + 3) & ~3;
+    uint32_t vdp2CmdOffset = ctrlOffset + ((trailer.pixelCtrlCnt + trailer.attrCtrlCnt) * sizeof(uint16_t));
+    if(vdp2CmdOffset + trailer.vdp2CmdDataSz != trailerOffset || trailer.vdp2CmdDataSz > sizeof(out->vdp2CmdData))
+        return false;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waddress-of-packed-member"
+    const uint16_t* pixelData = cmd->pixels;
+    const uint8_t* attrData = (const uint8_t*)cmd->pixels + (trailer.pixelDataCnt * sizeof(uint16_t));
+    const uint16_t* pixelCtrl = (const uint16_t*)(packet + ctrlOffset);
+    const uint16_t* attrCtrl = pixelCtrl + trailer.pixelCtrlCnt;
+
+    if(trailer.flags & TILE_CODEC_FLAG_RAW_PIXELS)
+    {
+        if(trailer.pixelDataCnt != NUM_ELEMS(out->pixels))
+            return false;
+        memcpy(out->pixels, pixelData, sizeof(out->pixels));
+    }
+    else if(!tile_codec_decode_rle16(pixelCtrl, trailer.pixelCtrlCnt, pixelData, trailer.pixelDataCnt, out->pixels, NUM_ELEMS(out->pixels)))
+        return false;
+
+    if(trailer.flags & TILE_CODEC_FLAG_UNIFORM_ATTR)
+    {
+        if(trailer.attrDataCnt != 1)
+            return false;
+        memset(out->attr, attrData[0], sizeof(out->attr));
+    }
+    else if(trailer.flags & TILE_CODEC_FLAG_RAW_ATTR)
+    {
+        if(trailer.attrDataCnt != NUM_ELEMS(out->attr))
+            return false;
+        memcpy(out->attr, attrData, sizeof(out->attr));
+    }
+    else if(!tile_codec_decode_rle8(attrCtrl, trailer.attrCtrlCnt, attrData, trailer.attrDataCnt, out->attr, NUM_ELEMS(out->attr)))
+        return false;
+#pragma GCC diagnostic pop
+
+    out->header = cmd->header;
+    out->header.cmd = EBusCmd_VDP2_TileFrameBuffer16bpp;
+    out->header.sz = sizeof(*out);
+    out->cmdSeqNum = cmd->cmdSeqNum;
+    out->cmdFlags = cmd->cmdFlags;
+    out->tileId = cmd->tileId;
+    out->passId = trailer.passId;
+    out->defaultBlendMode = trailer.defaultBlendMode;
+    out->vdp2CmdDataCount = trailer.vdp2CmdDataCount;
+    out->vdp2CmdDataSz = trailer.vdp2CmdDataSz;
+    memcpy(out->vdp2CmdData, packet + vdp2CmdOffset, trailer.vdp2CmdDataSz);
+    return true;
+}
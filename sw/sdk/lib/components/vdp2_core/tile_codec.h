@@ -0,0 +1,30 @@
+/** VDP1->VDP2 tile transfer codec. 
+ * Planes are run length encoded into a ctrl stream and a data stream, ctrl is a run ( 0x8000 | len ) with 1 data 
+ * element or a literal ( len ) with len data elements. Data never grows so encoding is done in place in the tile buffer 
+ * with the ctrl streams in scratch and appended after.
+*/
+#pragma once
+
+#include "picocom/platform.h"
+#include "picocom/display/display.h"
+#include "platform/pico/vdp2/hw_vdp2_types.h"
+
+#define TILE_CODEC_MAX_CTRL 1024            // Ctrl entries per plane, more wont pay off
+#define TILE_CODEC_RUN_FLAG 0x8000
+#define TILE_CODEC_MAX_LEN 0x7fff
+
+// VDP2TileRLETrailer.flags
+#define TILE_CODEC_FLAG_RAW_PIXELS 0x1      // Pixel plane sent as is, no ctrl
+#define TILE_CODEC_FLAG_RAW_ATTR 0x2        // Attr plane sent as is, no ctrl
+#define TILE_CODEC_FLAG_UNIFORM_ATTR 0x4    // Attr plane is a single value, filled on decode
+
+
+// codec api
+int32_t tile_codec_encode_rle16(uint16_t* data, uint32_t cnt, uint16_t* ctrl, uint32_t maxCtrl, bool write, uint32_t* dataCntOut);     // Encode in place, returns ctrl cnt or -1 if exceeds maxCtrl. write=false for size only
+int32_t tile_codec_encode_rle8(uint8_t* data, uint32_t cnt, uint16_t* ctrl, uint32_t maxCtrl, bool write, uint32_t* dataCntOut);
+bool tile_codec_decode_rle16(const uint16_t* ctrl, uint32_t ctrlCnt, const uint16_t* data, uint32_t dataCnt, uint16_t* out, uint32_t outCnt);
+bool tile_codec_decode_rle8(const uint16_t* ctrl, uint32_t ctrlCnt, const uint8_t* data, uint32_t dataCnt, uint8_t* out, uint32_t outCnt);
+
+// tile api
+uint32_t tile_codec_compress_tile16bpp(struct VDP2CMD_TileFrameBuffer16bpp* cmd, uint16_t* ctrlScratch, uint32_t ctrlScratchCnt, bool encodePlanes, bool attrUniform);     // Compress in place to VDP2CMD_TileFrameBuffer16bppRLE, returns packet size or 0 when raw is kept ( cmd untouched ). attrUniform sends attr[0] only
+bool tile_codec_decompress_tile16bpp(const struct VDP2CMD_TileFrameBuffer16bppRLE* cmd, struct VDP2CMD_TileFrameBuffer16bpp* out);     // Decode packet to raw tile
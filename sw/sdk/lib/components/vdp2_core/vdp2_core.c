@@ -6,6 +6,7 @@
 #include "picocom/devkit.h"
 #include "picocom/display/gfx.h"
 #include "platform/pico/vdp2/hw_vdp2_types.h"
+#include "tile_codec.h"
 #include <stdio.h>
 
 
@@ -98,6 +99,59 @@ static void vdp2_handler_main(struct BusRx_t* bus, struct Cmd_Header_t* frame)
 
         break;          
     }         
+    case EBusCmd_VDP2_TileFrameBuffer16bppRLE:      // VDP1 compressed tile render
+    {
+        struct VDP2CMD_TileFrameBuffer16bppRLE* cmd = (struct VDP2CMD_TileFrameBuffer16bppRLE*)frame;
+        
+        // block waiting for tile job to release
+        while(vdp->pendingTileCmd)
+        {
+            tight_loop_contents();
+        }
+
+        // decode job, expands to raw tile cmd
+        if(!tile_codec_decompress_tile16bpp(cmd, (struct VDP2CMD_TileFrameBuffer16bpp*)vdp->tileCmd))
+        {
+            printf("[vdp2] tile decode failed tileId: %d\n", cmd->tileId);
+            break;
+        }
+
+        // mark valid
+        vdp->pendingTileCmd = vdp->tileCmd;  
+
+        break;          
+    }    
+    case EBusCmd_VDP2_ReuseTile:      // VDP1 tile unchanged
+    {
+        struct VDP2CMD_ReuseTile* cmd = (struct VDP2CMD_ReuseTile*)frame;
+        
+        // block waiting for tile job to release
+        while(vdp->pendingTileCmd)
+        {
+            tight_loop_contents();
+        }
+
+        // copy job        
+        memcpy(vdp->tileCmd, cmd, sizeof(struct VDP2CMD_ReuseTile));
+
+        // mark valid
+        vdp->pendingTileCmd = vdp->tileCmd;  
+
+        break;          
+    }    
+    case EBusCmd_VDP2_BackgroundDrawCmdList:  // Background layers, held until next frame start
+    {
+        struct VDP2CMD_BackgroundDrawCmdList* cmd = (struct VDP2CMD_BackgroundDrawCmdList*)frame;
+        if(cmd->header.sz > sizeof(struct VDP2CMD_BackgroundDrawCmdList) || cmd->drawCmdDataSz > VDP2_BG_CMD_DATA_SZ)
+        {
+            printf("[vdp2] invalid background sz: %d\n", cmd->header.sz);
+            break;
+        }
+
+        memcpy(vdp->bgPendingCmd, cmd, cmd->header.sz);
+        vdp->bgPending = true;
+        break;
+    }
     case EBusCmd_VDP1_ForwardVDP2CmdData:  // VDP1 forwarding commands from app
     {
         struct VDP1CMD_DrawCmdData* cmd = (struct VDP1CMD_DrawCmdData*)frame;
@@ -162,6 +216,14 @@ int vdp2_init(struct vdp2_t* vdp, struct vdp2InitOptions_t* options)
     if(!vdp->tileCmd)
         return SDKErr_Fail;
 
+    // background layers, empty until app sets them
+    vdp->bgCmd = picocom_malloc(sizeof(VDP2CMD_BackgroundDrawCmdList));
+    vdp->bgPendingCmd = picocom_malloc(sizeof(VDP2CMD_BackgroundDrawCmdList));
+    if(!vdp->bgCmd || !vdp->bgPendingCmd)
+        return SDKErr_Fail;
+    memset(vdp->bgCmd, 0, sizeof(VDP2CMD_BackgroundDrawCmdList));
+    vdp->bgPending = false;
+
 #ifdef ENABLE_VDP2_GPU    
     // Alloc copy of max cmd    
     vdp->drawCmdMaxSz = vdp->vdp1_vdbus_rx->rx_buffer_size;
@@ -191,20 +253,40 @@ int vdp2_deinit(struct vdp2_t* vdp)
 }
 
 
-// CREDIT: https://stackoverflow.com/questions/18937701/combining-two-16-bits-rgb-colors-with-alpha-blending
-static uint16_t ALPHA_BLIT16_565(uint32_t fg, uint32_t bg, uint8_t alpha) {
-    // Alpha converted from [0..255] to [0..31]
-    uint32_t ALPHA = alpha >> 3;     
-    fg = (fg | fg << 16) & 0x07e0f81f;
-    bg = (bg | bg << 16) & 0x07e0f81f;
-    bg += (fg - bg) * ALPHA >> 5;
-    bg &= 0x07e0f81f;
-    return (uint16_t)(bg | bg >> 16);
+static void vdp2_latch_background(struct vdp2_t* vdp, uint16_t tileId, uint32_t passId)
+{
+    // swap on frame start so all tiles in a frame share scroll registers
+    if(!vdp->bgPending || tileId != 0 || passId != 0)
+        return;
+
+    struct VDP2CMD_BackgroundDrawCmdList* prev = vdp->bgCmd;
+    vdp->bgCmd = vdp->bgPendingCmd;
+    vdp->bgPendingCmd = prev;
+    vdp->bgPending = false;
+}
+
+
+static void vdp2_draw_background(struct vdp2_t* vdp, struct GpuInstance_t* gpuInstance, TileFrameBuffer_t* dstTileBuffer)
+{
+    struct VDP2CMD_BackgroundDrawCmdList* bg = vdp->bgCmd;
+    if(bg->drawCmdCnt == 0)
+        return;
+
+    struct GpuCommandList_t bgList = {0};
+    bgList.headerSz = 0;
+    bgList.allocSz = bg->drawCmdDataSz;
+    bgList.offset = 0;
+    bgList.cmdCount = bg->drawCmdCnt; 
+    bgList.cmdData = bg->drawCmdData;
+
+    gpu_run_tile(vdp->gpuState, gpuInstance, &bgList, dstTileBuffer);
 }
 
 
 void vdp2_write_tile16bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer16bpp* cmd)
 {    
+    vdp2_latch_background(vdp, cmd->tileId, cmd->passId);
+    
     struct GpuCommandList_t cmdList = {0};
     cmdList.headerSz = 0;
     cmdList.allocSz = cmd->header.sz;
@@ -266,6 +348,10 @@ void vdp2_write_tile16bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer16bp
         gpu_begin_frame(vdp->gpuState, gpuInstance, 0);                                  // reset gpu state every tile, not 100% correct but blend states need to be reset
         gpu_bind_fbo(vdp->gpuState, gpuInstance, &srcTileBuffer);
 
+        // background under app comp cmds
+        if(cmd->passId == 0)
+            vdp2_draw_background(vdp, gpuInstance, &dstTileBuffer);
+
         gpu_run_tile(vdp->gpuState, gpuInstance, &cmdList, &dstTileBuffer);              // Render command into tile
     } 
     else // default copy
@@ -284,6 +370,9 @@ void vdp2_write_tile16bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer16bp
             fillCmd.w = FRAME_W;
             fillCmd.h = FRAME_H;
             gpu_cmd_impl_FillRectCol(vdp->gpuState, gpuInstance, &fillCmd.header, &dstTileBuffer); 
+
+            // background layers, vdp1 tile comps on top
+            vdp2_draw_background(vdp, gpuInstance, &dstTileBuffer);
         }
 
         // run default comp
@@ -300,6 +389,8 @@ void vdp2_write_tile16bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer16bp
 
 void vdp2_write_tile8bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer8bpp* cmd)
 {    
+    vdp2_latch_background(vdp, cmd->tileId, cmd->passId);
+    
     struct GpuCommandList_t cmdList = {0};
     cmdList.headerSz = 0;
     cmdList.allocSz = cmd->header.sz;
@@ -361,6 +452,10 @@ void vdp2_write_tile8bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer8bpp*
         gpu_begin_frame(vdp->gpuState, gpuInstance, 0);                                  // reset gpu state every tile, not 100% correct but blend states need to be reset
         gpu_bind_fbo(vdp->gpuState, gpuInstance, &srcTileBuffer);
 
+        // background under app comp cmds
+        if(cmd->passId == 0)
+            vdp2_draw_background(vdp, gpuInstance, &dstTileBuffer);
+
         gpu_run_tile(vdp->gpuState, gpuInstance, &cmdList, &dstTileBuffer);              // Render command into tile
     } 
     else // default copy
@@ -379,6 +474,9 @@ void vdp2_write_tile8bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer8bpp*
             fillCmd.w = FRAME_W;
             fillCmd.h = FRAME_H;
             gpu_cmd_impl_FillRectCol(vdp->gpuState, gpuInstance, &fillCmd.header, &dstTileBuffer); 
+
+            // background layers, vdp1 tile comps on top
+            vdp2_draw_background(vdp, gpuInstance, &dstTileBuffer);
         }
 
         // run default comp
@@ -393,6 +491,63 @@ void vdp2_write_tile8bpp(struct vdp2_t* vdp, struct VDP2CMD_TileFrameBuffer8bpp*
 }
 
 
+void vdp2_reuse_tile(struct vdp2_t* vdp, struct VDP2CMD_ReuseTile* cmd)
+{
+    uint16_t* main_buffer = get_display_buffer();
+    if(!main_buffer || cmd->tileId >= FRAME_TILE_CNT_Y)
+        return;
+
+    // back buffer still holds previous frame when not flipped
+    if(!vdp->lastFrameFlipped)
+        return;
+
+    uint16_t* front_buffer = get_display_front_buffer();
+    if(!front_buffer || front_buffer == main_buffer)
+        return;
+
+    uint32_t rowIndex = cmd->tileId*FRAME_TILE_SZ_Y;
+    memcpy(main_buffer + (FRAME_W*rowIndex), front_buffer + (FRAME_W*rowIndex), FRAME_W*FRAME_TILE_SZ_Y*sizeof(uint16_t));
+}
+
+
+static bool vdp2_poll_flip(struct vdp2_t* vdp)
+{
+    if(!vdp->flipPending)
+        return true;
+
+    if(!flip_display_poll())
+        return false;
+
+    vdp->flipPending = false;
+    vdp->flipCount++;
+
+    // copy needs back buffer
+    if(vdp->pendingFrameFlags & EVDP1CMD_DrawCmdData_completeFlags_CopyFB)
+        display_buffer_copy_front(); 
+    vdp->pendingFrameFlags = 0;
+    return true;
+}
+
+
+static void vdp2_handle_frame_flags(struct vdp2_t* vdp, uint32_t cmdFlags)
+{
+    // flip async, next frame tile is received while scanout releases back buffer. Tiles only comp once prev flip done
+    if(cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay)
+    {
+        flip_display_async();
+        vdp->flipPending = true;
+        vdp->lastFrameFlipped = true;
+        vdp->pendingFrameFlags = cmdFlags;
+        return;
+    }
+    if(cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_CopyFB)
+    {
+        display_buffer_copy_front(); 
+        vdp->lastFrameFlipped = false;
+    } 
+}
+
+
 int vdp2_main(struct vdp2_t* vdp, struct vdp2MainLoopOptions_t* options)
 {
     // update loop (if options set)
@@ -412,10 +567,15 @@ bool hasBusCmd = false;
 
 int vdp2_update(struct vdp2_t* vdp, struct vdp2MainLoopOptions_t* options)
 {
-    bus_rx_update(vdp->vdp1_vdbus_rx);
+    // hold bus while tile waits on flip, rx handler blocks on pending tile
+    if(!vdp->pendingTileCmd)
+        bus_rx_update(vdp->vdp1_vdbus_rx);
     bus_tx_update(vdp->vdp1_xlnk_tx);    
 
-    if(vdp->pendingTileCmd)
+    // back buffer released by scanout
+    bool backBufferReady = vdp2_poll_flip(vdp);
+
+    if(vdp->pendingTileCmd && backBufferReady)
     {        
         switch (vdp->pendingTileCmd->cmd)
         {
@@ -433,16 +593,7 @@ int vdp2_update(struct vdp2_t* vdp, struct vdp2MainLoopOptions_t* options)
             vdp->pendingTileCmd = 0;
 
             // handle frame flipping
-            // NOTE: could do this async on core2, this will block slowing down core1
-            if(cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay)
-            {
-                flip_display_blocking(); 
-                vdp->flipCount++;
-            }
-            if(cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_CopyFB)
-            {
-                display_buffer_copy_front(); 
-            } 
+            vdp2_handle_frame_flags(vdp, cmdFlags);
             break;
         }
         case EBusCmd_VDP2_TileFrameBuffer8bpp:            
@@ -459,18 +610,25 @@ int vdp2_update(struct vdp2_t* vdp, struct vdp2MainLoopOptions_t* options)
             vdp->pendingTileCmd = 0;
 
             // handle frame flipping
-            // NOTE: could do this async on core2, this will block slowing down core1
-            if(cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_FlipDisplay)
-            {
-                flip_display_blocking(); 
-                vdp->flipCount++;
-            }
-            if(cmdFlags & EVDP1CMD_DrawCmdData_completeFlags_CopyFB)
-            {
-                display_buffer_copy_front(); 
-            } 
+            vdp2_handle_frame_flags(vdp, cmdFlags);
             break;
         }            
+        case EBusCmd_VDP2_ReuseTile:            
+        {
+            struct VDP2CMD_ReuseTile* tileCmd = (struct VDP2CMD_ReuseTile*)vdp->pendingTileCmd;
+
+            uint32_t cmdFlags = tileCmd->cmdFlags;
+
+            // keep previous frame pixels
+            vdp2_reuse_tile(vdp, tileCmd);
+
+            // mark free
+            vdp->pendingTileCmd = 0;
+
+            // handle frame flipping
+            vdp2_handle_frame_flags(vdp, cmdFlags);
+            break;
+        }
         default:
             break;
         }
@@ -493,6 +651,9 @@ int vdp2_update(struct vdp2_t* vdp, struct vdp2MainLoopOptions_t* options)
 
 void vdp_render_error(struct vdp2_t* vdp, uint32_t errorCode, const char* msg)
 {
+    if(!vdp2_poll_flip(vdp))
+        return;
+
     struct GpuInstance_t* gpuInstance = &vdp->gpuInstances[0];
     uint16_t* main_buffer = get_display_buffer();
     
@@ -33,7 +33,13 @@ typedef struct vdp2_t
     uint32_t drawCmdMaxSz;                              // Max alloc size (should match rx bus max packet)    
     struct Cmd_Header_t* pendingTileCmd;                  // Pending tile to comp     
     uint32_t flipCount;
+    bool lastFrameFlipped;                                // front buffer holds previous frame, reused tiles copy from it
+    bool flipPending;                                     // async flip waiting on scanout, back buffer not writable
+    uint32_t pendingFrameFlags;                           // frame flags deferred until flip completes
     uint32_t startupTime;
+    struct VDP2CMD_BackgroundDrawCmdList* bgCmd;          // Active background layers, run under pass zero tiles
+    struct VDP2CMD_BackgroundDrawCmdList* bgPendingCmd;   // Received background, latched on next frame start
+    bool bgPending;
 } vdp2_t;
 
 // vdp2 api
@@ -142,6 +142,23 @@ GpuState_t* gpu_init( struct GpuInitOptions_t* options)
         picocom_panic(SDKErr_Fail, "gpu buffer arena alloc fail");
     state->ram0BufferSz = options->bufferRamSz;
 
+    // Alloc scratch, one arena per instance so cores never share
+    state->scratchSz = options->scratchSz ? options->scratchSz : GPU_SCRATCH_DEFAULT_SZ;
+    for(int i=0;i<GPU_MAX_INSTANCES;i++)
+    {
+        state->scratch[i] = gpu_malloc(state->scratchSz);
+        if(!state->scratch[i])
+            picocom_panic(SDKErr_Fail, "gpu scratch alloc fail");
+    }
+
+    // Alloc tilemap caches, only gpus drawing tilemaps pay for them
+    if(options->enableTilemapCaches)
+    {
+        state->tilemapCaches = (struct GpuTilemapCaches_t*)gpu_malloc(sizeof(struct GpuTilemapCaches_t));
+        if(!state->tilemapCaches)
+            picocom_panic(SDKErr_Fail, "gpu tilemap caches alloc fail");
+    }
+
     // init export
     state->jitMethods[EGpuJitMethod_sqrtf] = sqrtf;
     
@@ -179,6 +196,15 @@ void gpu_deinit(GpuState_t* state)
     if(state->ram0BufferBase)
         gpu_free((uint8_t*)state->ram0BufferBase);
 
+    for(int i=0;i<GPU_MAX_INSTANCES;i++)
+    {
+        if(state->scratch[i])
+            gpu_free(state->scratch[i]);
+    }
+
+    if(state->tilemapCaches)
+        gpu_free((uint8_t*)state->tilemapCaches);
+
     gpu_free((uint8_t*)state);
 }
 
@@ -189,84 +215,349 @@ void gpu_clear_error_stats(GpuState_t* state, GpuInstance_t* job)
 }
 
 
+/** Tile bounds used to cull commands */
+typedef struct GpuTileCullInfo_t
+{
+    uint16_t tileMask;
+    uint32_t tileMinY;
+    uint32_t tileMaxY;
+    uint32_t tileMaxX;      // In header cull rect units
+} GpuTileCullInfo_t;
+
+
+static inline void gpu_init_tile_cull_info(TileFrameBuffer_t* tile, GpuTileCullInfo_t* cull)
+{
+    // Tiles span full frame width
+    cull->tileMask = 1 << tile->tileId;
+    cull->tileMinY = tile->y;
+    cull->tileMaxY = tile->y + tile->h;
+    cull->tileMaxX = CEIL_INT(tile->w, GPU_CMD_CULL_RECT_X_SCALE);
+}
+
+
+/** Cull & dispatch single cmd into tile */
+static inline void gpu_run_tile_cmd(GpuState_t* state, GpuInstance_t* job, GpuCmd_Header* header, TileFrameBuffer_t* tile, const GpuTileCullInfo_t* cull)
+{
+    // cull tile        
+    if( header->flags & EGpuCmd_Header_Flags_TileCullMask ) // zero/uninit no culling run on all
+    {
+        if((cull->tileMask & header->cullTileMask) == 0)
+        {
+            // profiler
+            if(job->enableProfiler)
+            {            
+                job->frameProfile->frameCullCounts++;
+            }        
+            return;
+        }
+    }
+
+    // cull rect, skip cmd outside tile before dispatch
+    if( header->flags & EGpuCmd_Header_Flags_CullRect )
+    {
+        if(header->cullMinX >= header->cullMaxX || header->cullMinX >= cull->tileMaxX
+            || header->cullMinY >= cull->tileMaxY || header->cullMaxY <= cull->tileMinY)
+        {
+            if(job->enableProfiler)
+            {            
+                job->frameProfile->frameCullCounts++;
+            }        
+            return;
+        }
+    }
+
+    job->debugCmdId++;            
+
+    // profiler, nested cmds eg. CallCmdList are profiled on their own & excluded from parent
+    uint32_t cmdStart;
+    uint32_t parentNestedCycles;
+    if(job->enableProfiler)
+    {
+        parentNestedCycles = job->profileNestedCycles;
+        job->profileNestedCycles = 0;
+        cmdStart = picocom_cycles_32();
+    }
+
+    // dispatch
+    if(header->cmd < GPU_MAX_SHADER_CMD_ID)
+    {
+        ShaderCmdExec_t cmd = job->trustedCmds ? state->cmdsUnchecked[header->cmd] : state->cmds[header->cmd];
+        if(cmd)
+        {
+            uint32_t scratchMark = gpu_scratch_mark(job);
+            if(job->enableDebuger && job->debugSelectCmdIndex != -1)
+            {
+                if(job->debugSelectCmdIndex == job->debugCmdId)
+                    cmd(state, job, header, tile);
+            }
+            else
+            {
+                cmd(state, job, header, tile);
+            }
+            gpu_scratch_release(job, scratchMark); // cmd temporaries, freed even on early error returns
+        }
+    }
+
+    if(header->sz > 65535)
+    {            
+        picocom_panic(SDKErr_Fail, "Corrupt GPU Cmd, header->sz > 65535");
+    }
+    
+    // profiler
+    if(job->enableProfiler)
+    {            
+        uint32_t cycles = picocom_cycles_diff(cmdStart, picocom_cycles_32());
+        uint32_t nestedCycles = job->profileNestedCycles;
+        gpu_profile_add_cmd(job->frameProfile, header->cmd, cycles > nestedCycles ? cycles - nestedCycles : 0);
+        job->profileNestedCycles = parentNestedCycles + cycles;
+    }        
+}
+
+
+void gpu_profile_add_cmd(GpuFrameProfile* profile, uint8_t cmdId, uint32_t cycles)
+{
+    if(cmdId >= GPU_PROFILE_MAX_CMD_ID)
+        return;
+
+    GpuCmdProfile_t* cmdProfile = &profile->cmds[cmdId];
+    cmdProfile->execCnt++;
+    cmdProfile->totalCycles += cycles;
+    if(cycles > cmdProfile->maxCycles)
+        cmdProfile->maxCycles = cycles;
+
+    // log2 bin, 0 cycles in bin 0
+    uint32_t bin = cycles ? 32 - __builtin_clz(cycles) : 0;
+    if(bin >= GPU_PROFILE_HIST_BINS)
+        bin = GPU_PROFILE_HIST_BINS - 1;
+    if(cmdProfile->hist[bin] != 0xffff)
+        cmdProfile->hist[bin]++;
+}
+
+
+void gpu_profile_merge(GpuFrameProfile* dst, const GpuFrameProfile* src)
+{
+    if(!src->isValid)
+        return;
+
+    dst->isValid = true;
+    dst->cmdSeqNum = src->cmdSeqNum;
+    dst->cyclesPerUs = src->cyclesPerUs;
+    dst->frameCullCounts += src->frameCullCounts;
+    for(int i=0;i<GPU_PROFILE_MAX_CMD_ID;i++)
+    {
+        const GpuCmdProfile_t* s = &src->cmds[i];
+        if(s->execCnt == 0)
+            continue;
+
+        GpuCmdProfile_t* d = &dst->cmds[i];
+        d->execCnt += s->execCnt;
+        d->totalCycles += s->totalCycles;
+        if(s->maxCycles > d->maxCycles)
+            d->maxCycles = s->maxCycles;
+        for(int j=0;j<GPU_PROFILE_HIST_BINS;j++)
+        {
+            uint32_t cnt = d->hist[j] + s->hist[j];
+            d->hist[j] = cnt > 0xffff ? 0xffff : cnt;
+        }
+    }
+}
+
+
 void gpu_run_tile(GpuState_t* state, GpuInstance_t* job, GpuCommandList_t* commands, TileFrameBuffer_t* tile)
 {    
     if(!commands)
         return;
         
     uint32_t startTime = picocom_time_us_32();
-    uint16_t tileMask = 1 << tile->tileId;
+    GpuTileCullInfo_t cull;
+    gpu_init_tile_cull_info(tile, &cull);
     
     int i = commands->headerSz;   
     int index = 0;       
-    uint32_t cmdStart;
     while(i < commands->allocSz && index < commands->cmdCount)
     {
         GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[i];    
         if(header->sz == 0)
             break;
-        
-        // cull tile        
-        if( header->flags & EGpuCmd_Header_Flags_TileCullMask ) // zero/uninit no culling run on all
+
+        gpu_run_tile_cmd(state, job, header, tile, &cull);
+
+        i += header->sz;
+        index++;
+    }
+
+    // profile
+    uint32_t took = picocom_time_us_32() - startTime;
+    if(took > job->tileMaxTime)
+        job->tileMaxTime = took;    
+}
+
+
+void gpu_run_tile_cmd_list_buffer(GpuState_t* state, GpuInstance_t* job, struct GpuBufferInfo* buffer, TileFrameBuffer_t* tile, int16_t offsetX, int16_t offsetY)
+{
+    if(!buffer || !buffer->cmdListValid)
+        return;
+
+    GpuTileCullInfo_t cull;
+    gpu_init_tile_cull_info(tile, &cull);
+
+    // list buffer validated without buffer state, run checked cmds
+    bool trustedCmds = job->trustedCmds;
+    job->trustedCmds = false;
+
+    bool translate = offsetX != 0 || offsetY != 0;
+    uint32_t i = 0;
+    for(int index=0;index<buffer->cmdListCnt;index++)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)&buffer->basePtr[i];
+        i += header->sz;
+
+        ShaderCmdTranslate_t translateCmd = translate ? state->cmdInfos[header->cmd].translate : 0;
+        if(!translateCmd)
         {
-            if((tileMask & header->cullTileMask) == 0)
-            {
-                // profiler
-                if(job->enableProfiler)
-                {            
-                    job->frameProfile.frameCullCounts++;
-                }        
-                // next
-                i += header->sz;
-                index++;           
-                continue;
-            }
+            gpu_run_tile_cmd(state, job, header, tile, &cull);
+            continue;
         }
 
-        job->debugCmdId++;            
-
-        // profiler
-        if(job->enableProfiler)
+        // offset copy in instance scratch, list stays shared between cores
+        uint32_t scratchMark = gpu_scratch_mark(job);
+        GpuCmd_Header* translated = (GpuCmd_Header*)gpu_scratch_alloc(job, header->sz);
+        if(!translated)
         {
-            //job->frameProfile.cmdExecCounts[header->cmd]++;
-            cmdStart = picocom_time_us_32();
+            gpu_error(state, job, EGpuErrorCode_OutOfBounds, "Cmd too large to translate");
+            continue;
         }
+        memcpy(translated, header, header->sz);
 
-        // check cull
+        // culling was calculated for the untranslated cmd, cmds clip themselves
+        translated->flags &= ~(EGpuCmd_Header_Flags_TileCullMask | EGpuCmd_Header_Flags_CullRect);
+        translateCmd(translated, offsetX, offsetY);
+        gpu_run_tile_cmd(state, job, translated, tile, &cull);
+        gpu_scratch_release(job, scratchMark);
+    }
 
-        // dispatch
-        if(header->cmd < GPU_MAX_SHADER_CMD_ID)
+    job->trustedCmds = trustedCmds;
+}
+
+/** Tiles touched by cmd, cull rect narrows the tile mask */
+uint16_t gpu_calc_cmd_tile_mask(GpuCmd_Header* header, uint16_t allTilesMask)
+{
+    uint16_t mask = allTilesMask;
+    if( header->flags & EGpuCmd_Header_Flags_TileCullMask )
+        mask &= header->cullTileMask;
+
+    if( header->flags & EGpuCmd_Header_Flags_CullRect )
+    {
+        if(header->cullMinX >= header->cullMaxX || header->cullMinY >= header->cullMaxY)
+            return 0;
+        mask &= gpu_calc_tile_cull_mask_line(header->cullMinY, header->cullMaxY);
+    }
+
+    return mask;
+}
+
+
+bool gpu_build_tile_bins(GpuCommandList_t* commands, GpuTileBins_t* bins, uint32_t tileCnt)
+{
+    bins->valid = false;
+    if(!commands || !bins->cmdOffsets || tileCnt > GPU_MAX_TILE_BINS)
+        return false;
+
+    // Offsets stored as u16
+    if(commands->allocSz > 0xffff)
+        return false;
+
+    memset(bins->tileStart, 0, sizeof(bins->tileStart));
+    memset(bins->tileCount, 0, sizeof(bins->tileCount));
+    uint16_t allTilesMask = (1 << tileCnt) - 1;
+
+    // count pass
+    uint32_t total = 0;
+    int i = commands->headerSz;   
+    int index = 0;       
+    while(i < commands->allocSz && index < commands->cmdCount)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[i];    
+        if(header->sz == 0)
+            break;
+
+        uint16_t mask = gpu_calc_cmd_tile_mask(header, allTilesMask);
+        for(int t=0;t<tileCnt;t++)
         {
-            ShaderCmdExec_t cmd = state->cmds[header->cmd];
-            if(cmd)
+            if(mask & (1 << t))
             {
-                if(job->enableDebuger && job->debugSelectCmdIndex != -1)
-                {
-                    if(job->debugSelectCmdIndex == job->debugCmdId)
-                        cmd(state, job, header, tile);
-                }
-                else
-                {
-                    cmd(state, job, header, tile);
-                }
+                bins->tileCount[t]++;
+                total++;
             }
         }
 
-        if(header->sz > 65535)
-        {            
-            picocom_panic(SDKErr_Fail, "Corrupt GPU Cmd, header->sz > 65535");
+        i += header->sz;
+        index++;
+    }
+    bins->cmdCount = index;
+
+    if(total > bins->cmdOffsetsCapacity)
+        return false;
+
+    uint32_t start = 0;
+    for(int t=0;t<tileCnt;t++)
+    {
+        bins->tileStart[t] = start;
+        start += bins->tileCount[t];
+        bins->tileCount[t] = 0;
+    }
+
+    // fill pass, list order kept per tile
+    i = commands->headerSz;   
+    index = 0;       
+    while(i < commands->allocSz && index < bins->cmdCount)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[i];    
+
+        uint16_t mask = gpu_calc_cmd_tile_mask(header, allTilesMask);
+        for(int t=0;t<tileCnt;t++)
+        {
+            if(mask & (1 << t))
+                bins->cmdOffsets[ bins->tileStart[t] + bins->tileCount[t]++ ] = i;
         }
 
         i += header->sz;
         index++;
-        
-        // profiler
-        if(job->enableProfiler)
-        {            
-            uint32_t took = picocom_time_us_32() - cmdStart;
-            //if(took > job->frameProfile.cmdMaxTime[header->cmd])
-              //  job->frameProfile.cmdMaxTime[header->cmd] = took;
-        }        
+    }
+
+    bins->valid = true;
+    return true;
+}
+
+
+void gpu_run_tile_binned(GpuState_t* state, GpuInstance_t* job, GpuCommandList_t* commands, const GpuTileBins_t* bins, TileFrameBuffer_t* tile)
+{
+    if(!commands)
+        return;
+
+    if(!bins || !bins->valid || tile->tileId >= GPU_MAX_TILE_BINS)
+    {
+        gpu_run_tile(state, job, commands, tile);
+        return;
+    }
+
+    uint32_t startTime = picocom_time_us_32();
+    GpuTileCullInfo_t cull;
+    gpu_init_tile_cull_info(tile, &cull);
+
+    const uint16_t* offsets = bins->cmdOffsets + bins->tileStart[tile->tileId];
+    uint32_t cnt = bins->tileCount[tile->tileId];
+
+    // profiler, binned out cmds count as culled
+    if(job->enableProfiler)
+    {
+        job->frameProfile->frameCullCounts += bins->cmdCount - cnt;
+    }
+
+    for(int i=0;i<cnt;i++)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[offsets[i]];
+        gpu_run_tile_cmd(state, job, header, tile, &cull);
     }
 
     // profile
@@ -276,6 +567,56 @@ void gpu_run_tile(GpuState_t* state, GpuInstance_t* job, GpuCommandList_t* comma
 }
 
 
+static inline uint32_t gpu_hash_bytes(uint32_t hash, const uint8_t* data, uint32_t sz)
+{
+    // FNV-1a
+    for(int i=0;i<sz;i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+uint32_t gpu_hash_tile_cmds(GpuState_t* state, GpuCommandList_t* commands, const GpuTileBins_t* bins, uint32_t tileId, uint32_t seed)
+{
+    uint32_t hash = gpu_hash_bytes(2166136261u, (const uint8_t*)&seed, sizeof(seed));
+
+    // cmds dont expose buffer refs, any buffer write changes every tile
+    hash = gpu_hash_bytes(hash, (const uint8_t*)&state->bufferWriteCnt, sizeof(state->bufferWriteCnt));
+    if(!commands)
+        return hash;
+
+    if(bins && bins->valid && tileId < GPU_MAX_TILE_BINS)
+    {
+        const uint16_t* offsets = bins->cmdOffsets + bins->tileStart[tileId];
+        uint32_t cnt = bins->tileCount[tileId];
+        for(int i=0;i<cnt;i++)
+        {
+            GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[offsets[i]];
+            hash = gpu_hash_bytes(hash, (const uint8_t*)header, header->sz);
+        }
+        return hash;
+    }
+
+    // not binned, hash all cmds
+    int i = commands->headerSz;   
+    int index = 0;       
+    while(i < commands->allocSz && index < commands->cmdCount)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[i];    
+        if(header->sz == 0)
+            break;
+
+        hash = gpu_hash_bytes(hash, (const uint8_t*)header, header->sz);
+        i += header->sz;
+        index++;
+    }
+    return hash;
+}
+
+
 void gpu_dump_cmds(GpuState_t* state, GpuCommandList_t* commands)
 {
     int i = commands->headerSz;        
@@ -335,10 +676,18 @@ void gpu_begin_frame(GpuState_t* state, GpuInstance_t* job, uint32_t frameId)
     // reset counters
     job->frameTileCnt = 0;
     job->tileMaxTime = 0;    
+    job->scratchOffset = 0;
+    job->profileNestedCycles = 0;
     if(job->enableProfiler)
     {
-        memset(&job->frameProfile, 0, sizeof(job->frameProfile)); // zero
-        job->frameProfile.cmdSeqNum = frameId;
+        // profile accumulates over frames/tiles until owner clears it
+        if(job->frameProfile)
+        {
+            job->frameProfile->cmdSeqNum = frameId;
+            job->frameProfile->cyclesPerUs = picocom_cycles_per_us();
+        }
+        else
+            job->enableProfiler = false;
     }
     job->fb0 = 0;
 }
@@ -364,11 +713,7 @@ void gpu_end_frame(GpuState_t* state, GpuInstance_t* job)
 
     if(job->enableProfiler)
     {
-        job->frameProfile.isValid = true;
-    }
-    else 
-    {
-        job->frameProfile.isValid = false;
+        job->frameProfile->isValid = true;
     }
 }
 
@@ -407,6 +752,64 @@ bool gpu_validate_cmds_list(GpuState_t* state, GpuCommandList_t* commands, struc
 }
 
 
+bool gpu_trust_cmds_list(GpuState_t* state, GpuCommandList_t* commands)
+{
+    if(!commands)
+        return false;
+
+    GpuValidationOutput_t info;
+    memset(&info, 0, sizeof(info));
+    info.checkBufferState = true;
+
+    uint32_t i = commands->headerSz;   
+    for(int index=0;index<commands->cmdCount;index++)
+    {
+        if(i + sizeof(GpuCmd_Header) > commands->allocSz)
+            return false;
+
+        GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[i];    
+        if(header->sz < sizeof(GpuCmd_Header) || i + header->sz > commands->allocSz)
+            return false;
+        if(header->cmd >= GPU_MAX_SHADER_CMD_ID || !state->cmds[header->cmd])
+            return false;
+
+        // buffer state checked here may change mid list
+        const GpuCmdInfo_t* cmdInfo = &state->cmdInfos[header->cmd];
+        if(cmdInfo->writesBuffers)
+            return false;
+        if(cmdInfo->validator && !cmdInfo->validator(state, header, &info))
+            return false;
+
+        i += header->sz;
+    }
+
+    return true;
+}
+
+
+void gpu_prepare_cmds_list(GpuState_t* state, GpuCommandList_t* commands)
+{
+    if(!commands)
+        return;
+
+    uint32_t i = commands->headerSz;   
+    for(int index=0;index<commands->cmdCount;index++)
+    {
+        if(i + sizeof(GpuCmd_Header) > commands->allocSz)
+            return;
+
+        GpuCmd_Header* header = (GpuCmd_Header*)&commands->cmdData[i];    
+        if(header->sz < sizeof(GpuCmd_Header) || i + header->sz > commands->allocSz)
+            return;
+
+        if(header->cmd < GPU_MAX_SHADER_CMD_ID && state->cmdInfos[header->cmd].prepare)
+            state->cmdInfos[header->cmd].prepare(state, header);
+
+        i += header->sz;
+    }
+}
+
+
 bool gpu_validate_cmds_listlist(GpuState_t* state, GpuCommandListList_t* cmdListList, GpuValidationOutput_t* info)
 {
     if(!info)
@@ -427,6 +830,52 @@ bool gpu_validate_cmds_listlist(GpuState_t* state, GpuCommandListList_t* cmdList
 }
 
 
+bool gpu_validate_cmd_list_buffer(GpuState_t* state, struct GpuBufferInfo* buffer, struct GpuValidationOutput_t* info)
+{
+    if(!buffer)
+        return false;
+
+    // run on upload with bufferWriteLock held, CallCmdList only reads the result
+    buffer->cmdListValid = false;
+    buffer->cmdListCnt = 0;
+    if(!buffer->isValid || !buffer->basePtr || buffer->textureFormat != ETextureFormat_CmdList)
+        return false;
+
+    uint32_t i = 0;   
+    uint32_t index = 0;       
+    while(i + sizeof(GpuCmd_Header) <= buffer->size)
+    {
+        GpuCmd_Header* header = (GpuCmd_Header*)&buffer->basePtr[i];    
+        if(header->sz == 0)
+            break;
+
+        // cmd must fit, no nested calls or buffer writes ( list buffer walked by both cores every tile )
+        if(header->sz < sizeof(GpuCmd_Header) || i + header->sz > buffer->size || index >= 0xffff
+            || header->cmd >= GPU_MAX_SHADER_CMD_ID || header->cmd == EGPUCMD_CallCmdList
+            || state->cmdInfos[header->cmd].writesBuffers)
+        {
+            info->cmdIndex = index;
+            info->cmdDataOffset = i;
+            return false;
+        }
+
+        ShaderCmdValidate_t cmd = state->cmdInfos[header->cmd].validator;
+        if(cmd && !cmd(state, header, info))
+        {
+            info->cmdIndex = index;
+            info->cmdDataOffset = i;
+            return false;
+        }
+
+        i += header->sz;
+        index++;
+    }
+
+    buffer->cmdListCnt = index;
+    buffer->cmdListValid = true;
+    return true;
+}
+
 void gpu_print_validator_error( struct GpuValidationOutput_t* info)
 {
     printf("errorCode: %d\n", info->errorCode);
@@ -443,6 +892,7 @@ void gpu_register_cmd(GpuState_t* state, GpuCmdInfo_t info)
 {
     state->cmdInfos[info.id] = info;
     state->cmds[info.id] = info.cmd;
+    state->cmdsUnchecked[info.id] = info.cmdUnchecked ? info.cmdUnchecked : info.cmd;
 }
 
 
@@ -477,6 +927,7 @@ int gpu_register_cmd_jit(GpuState_t* state, uint8_t cmdId, uint8_t bufferId)
 
     state->cmdInfos[info.id] = info;
     state->cmds[info.id] = info.cmd;
+    state->cmdsUnchecked[info.id] = info.cmdUnchecked ? info.cmdUnchecked : info.cmd;
 
     return SDKErr_OK;
 }
@@ -504,11 +955,7 @@ struct Col16_t gpu_col_from_rgbf(float rf, float gf, float bf)
 
 struct Col16_t gpu_col_from_rgba_hex(uint32_t rgb)
 {
-    return gpu_col_from_rgbf(
-        ((rgb & 0xff0000) >> 16) / 255.0f,
-        ((rgb & 0xff00) >> 8) / 255.0f,
-        ((rgb & 0xff) >> 0) / 255.0f
-    );
+    return gpu_col_from_uint16(gpu_col_from_rgb888_uint16(rgb));
 }
 
 
@@ -560,32 +1007,19 @@ struct Col16_t gpu_rgbf_to_col(struct ColRGBF_t colf)
 }
 
 
-uint16_t gpu_col_add_uint16(uint16_t a, uint16_t b)
-{
-    Col16_t ca, cb, res;
-    res.value = 0xffff;
-    ca.value = a;
-    cb.value = b;
-
-    if(ca.r + cb.r < 31)
-        res.r = ca.r + cb.r;
-    if(ca.g + cb.g < 63)
-        res.g = ca.g + cb.g;        
-    if(ca.b + cb.b < 31)
-        res.b = ca.b + cb.b;
-    return res.value;        
-}
-
-
 void gpu_reset(GpuState_t* state, uint8_t cmds, uint8_t buffers, uint8_t stats)
 {
     if(!state)
         return;
 
+    state->bufferWriteCnt++;
+
     // Buffers
     if(buffers)
     {
         memset(&state->buffers, 0, sizeof(state->buffers));
+        if(state->tilemapCaches)
+            memset(state->tilemapCaches, 0, sizeof(struct GpuTilemapCaches_t));
 
         // Ram arena
         if( state->ram0BufferBase && state->ram0BufferSz)
@@ -597,6 +1031,7 @@ void gpu_reset(GpuState_t* state, uint8_t cmds, uint8_t buffers, uint8_t stats)
     {
         memset(&state->cmdInfos, 0, sizeof(state->cmdInfos));
         memset(&state->cmds, 0, sizeof(state->cmds));        
+        memset(&state->cmdsUnchecked, 0, sizeof(state->cmdsUnchecked));
         // init default commands 
         gpu_init_commands(state);        
     }    
@@ -605,8 +1040,38 @@ void gpu_reset(GpuState_t* state, uint8_t cmds, uint8_t buffers, uint8_t stats)
 
 void gpu_init_instance(GpuState_t* state, GpuInstance_t* job, uint32_t instanceId)
 {
+    // every instance needs its scratch arena, DrawTileMap fails without
+    if(instanceId >= GPU_MAX_INSTANCES)
+        picocom_panic(SDKErr_Fail, "gpu instanceId >= GPU_MAX_INSTANCES");
+
     memset(job, 0, sizeof(*job));
     job->instanceId = instanceId;
+    job->scratchBase = state->scratch[instanceId];
+    job->scratchSz = state->scratchSz;
+}
+
+
+void* gpu_scratch_alloc(GpuInstance_t* job, uint32_t sz)
+{
+    uint32_t offset = (job->scratchOffset + 3) & ~3;
+    if(!job->scratchBase || sz > job->scratchSz || offset > job->scratchSz - sz)
+        return 0;
+
+    job->scratchOffset = offset + sz;
+    return job->scratchBase + offset;
+}
+
+
+uint32_t gpu_scratch_mark(GpuInstance_t* job)
+{
+    return job->scratchOffset;
+}
+
+
+void gpu_scratch_release(GpuInstance_t* job, uint32_t mark)
+{
+    if(mark < job->scratchOffset)
+        job->scratchOffset = mark;
 }
 
 
@@ -645,6 +1110,27 @@ uint16_t gpu_calc_tile_cull_mask_line(int32_t minY, int32_t maxY)
 }
 
 
+void gpu_set_cmd_cull_rect(GpuCmd_Header* header, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    // Clamp to frame, empty rect culls on all tiles
+    int32_t minX = MAX(x, 0);
+    int32_t maxX = MIN(x + w, FRAME_W);
+    int32_t minY = MAX(y, 0);
+    int32_t maxY = MIN(y + h, FRAME_H);
+    if(minX >= maxX || minY >= maxY)
+    {
+        minX = maxX = minY = maxY = 0;
+    }
+
+    // Round x outwards
+    header->cullMinX = FLOOR_INT(minX, GPU_CMD_CULL_RECT_X_SCALE);
+    header->cullMaxX = CEIL_INT(maxX, GPU_CMD_CULL_RECT_X_SCALE);
+    header->cullMinY = minY;
+    header->cullMaxY = maxY;
+    header->flags |= EGpuCmd_Header_Flags_CullRect;
+}
+
+
 struct GpuBufferInfo* gpu_get_buffer_by_id(GpuState_t* state, uint32_t id)
 {
     if(id >= GPU_MAX_BUFFER_ID)
@@ -22,6 +22,8 @@ struct GpuValidationOutput_t;
 typedef void (*ShaderCmdExec_t)(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* cmd, TileFrameBuffer_t* tile);
 typedef bool (*ShaderCmdValidate_t)(const struct GpuState_t* gpu, struct GpuCmd_Header* cmd, struct GpuValidationOutput_t* info);
 typedef bool (*ShaderCmdToString_t)(const struct GpuState_t* gpu, struct GpuCmd_Header* cmd, char* buff, uint32_t buffSz);
+typedef void (*ShaderCmdTranslate_t)(struct GpuCmd_Header* cmd, int16_t dx, int16_t dy);
+typedef void (*ShaderCmdPrepare_t)(struct GpuState_t* gpu, struct GpuCmd_Header* cmd);
 
 
 /** Gpu validate macro assert
@@ -34,14 +36,20 @@ if( (!(Expression)) ) { \
 }\
 
 #else
-#define GPU_VALIDATE_ASSERT(Expression) 
+#define GPU_VALIDATE_ASSERT(Expression) \
+if( (!(Expression)) ) { \
+    return false; \
+}\
+
 #endif
 
 /** Gpu init options */
 typedef struct GpuInitOptions_t
 {
     uint32_t bufferRamSz;
+    uint32_t scratchSz;                 // per instance scratch arena size, 0 uses GPU_SCRATCH_DEFAULT_SZ
     bool enableFlash;
+    bool enableTilemapCaches;           // alloc GpuTilemapCaches_t for DrawTileMap & DrawWater prepare, tiles resolve per cell without
 } GpuInitOptions_t;
 
 
@@ -53,6 +61,10 @@ typedef struct GpuCmdInfo_t
     ShaderCmdExec_t cmd;
     ShaderCmdValidate_t validator;
     ShaderCmdToString_t toString;
+    ShaderCmdTranslate_t translate;     // Offset screen position, cmds without run unmoved in offset cmd lists
+    ShaderCmdExec_t cmdUnchecked;       // Skips per cmd buffer checks, only dispatched for lists trusted by gpu_trust_cmds_list
+    bool writesBuffers;                 // Changes buffers or cmds, lists containing it are never trusted
+    ShaderCmdPrepare_t prepare;         // Run once per list before tiles by gpu_prepare_cmds_list, eg. refresh caches tiles read
 } GpuCmdInfo_t;
 
 
@@ -70,6 +82,7 @@ typedef struct GpuValidationOutput_t {
     int extraArg0;          // Per debug arg eg. buffer id
     int extraCmdBaseSize;   // Base size of cmd
     int extraDataBaseSize;  // Size of data elements (variable sized cmds)
+    bool checkBufferState;  // Also validate referenced buffers against current gpu state
     //uint8_t buffersCreated[GPU_MAX_BUFFER_ID];
 } GpuValidationOutput_t;
 
@@ -81,6 +94,72 @@ typedef struct GpuResult_t
 } GpuResult_t;
 
 
+/** Resolved autotiles for a tilemap chunk, refreshed by DrawTileMap prepare when the chunk, edges or attribs are written */
+typedef struct GpuTilemapCache_t
+{
+    struct GpuBufferInfo* tilemapDataBuffer;    // Cached chunk, 0 when unused
+    struct GpuBufferInfo* tilemapAttribBuffer;  // Tile infos resolved against
+    uint8_t tileIdMask;
+    uint32_t attribWriteCnt;                    // Attrib writeCnt resolved at
+    struct GpuBufferInfo* edges[9];             // Chunk ( centre ) & linked edges resolved against
+    uint32_t edgeWriteCnts[9];                  // Chunk & edge writeCnt resolved at
+    uint32_t lastPrepareId;                     // Eviction age
+    uint8_t tileIds[GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ];     // Masked chunk tile ids, diffed to find changed cells
+    uint8_t autoTileIds[GPU_TILEMAP_CACHE_LAYERS][GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ];  // Resolved tileLookup per layer & cell, 0xff resolves per tile
+} GpuTilemapCache_t;
+
+
+/** Tilemap anim phases for a cmd seed, only depend on seed & cell so shared between chunks */
+typedef struct GpuTilemapPhases_t
+{
+    bool isValid;
+    uint32_t seed;                              // Cmd seed phases built for, other seeds use rng per tile
+    uint32_t lastPrepareId;                     // Eviction age
+    uint16_t phases[GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ];    // Anim frame offset per cell, seeded rng % GPU_TILE_PHASE_MOD
+} GpuTilemapPhases_t;
+
+
+#define GPU_FLUID_CELL_LAYER_MASK 0x07      // Water layer from cell state, 7 when fluid above
+#define GPU_FLUID_CELL_ABOVE 0x08           // Fluid in cell above, wave pixels replaced
+#define GPU_FLUID_CELL_SKIP 0x80            // Invalid tile or overlay, not drawn
+
+/** Fluid neighbourhood of a water chunk, refreshed by DrawWater prepare when the chunk, its state, the chunk above or attribs are written */
+typedef struct GpuFluidCache_t
+{
+    struct GpuBufferInfo* tilemapDataBuffer;    // Cached chunk, 0 when unused
+    struct GpuBufferInfo* stateDataBuffer;      // Fluid mass per cell
+    struct GpuBufferInfo* tilemapAttribBuffer;  // Tile infos evaluated against
+    uint8_t tileIdMask;
+    uint32_t attribWriteCnt;                    // Attrib writeCnt evaluated at
+    struct GpuBufferInfo* sources[4];           // Chunk data & state, above edge data & state
+    uint32_t sourceWriteCnts[4];                // Source writeCnt evaluated at
+    uint32_t lastPrepareId;                     // Eviction age
+    uint8_t cells[GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ];      // GPU_FLUID_CELL_* per cell
+} GpuFluidCache_t;
+
+
+/** Opaque tiles of an 8x8 layer sheet at a frame offset, refreshed by DrawTileMap prepare when the texture is written */
+typedef struct GpuTileOpaqueSheet_t
+{
+    struct GpuBufferInfo* texture;              // Layer texture, 0 when unused
+    uint32_t textureWriteCnt;                   // Texture writeCnt scanned at
+    uint16_t x, y;                              // Sheet frame offset in texture
+    uint32_t lastPrepareId;                     // Eviction age
+    uint64_t opaqueTiles;                       // Bit per 16x16 tile ( x + y*8 ) with no transparent pixels, lets AutoTile/Decals hide lower layers
+} GpuTileOpaqueSheet_t;
+
+
+/** Tilemap prepare caches, written by prepare only & read by tiles. Only allocated for gpus that draw tilemaps */
+typedef struct GpuTilemapCaches_t
+{
+    GpuTilemapCache_t tilemapCache[GPU_TILEMAP_CACHE_CNT];
+    GpuTilemapPhases_t tilemapPhases[GPU_TILE_PHASE_CNT];
+    GpuFluidCache_t fluidCache[GPU_FLUID_CACHE_CNT];
+    GpuTileOpaqueSheet_t opaqueSheets[GPU_TILE_OPAQUE_SHEET_CNT];
+    uint32_t prepareCnt;                        // Eviction clock
+} GpuTilemapCaches_t;
+
+
 /** Gpu state */
 typedef struct GpuState_t
 {    
@@ -91,10 +170,12 @@ typedef struct GpuState_t
     // commands
     GpuCmdInfo_t cmdInfos[GPU_MAX_SHADER_CMD_ID];    
     ShaderCmdExec_t cmds[GPU_MAX_SHADER_CMD_ID];    
+    ShaderCmdExec_t cmdsUnchecked[GPU_MAX_SHADER_CMD_ID];   // cmds for trusted lists, falls back to cmds
     
     // Buffers
     struct GpuBufferInfo buffers[GPU_MAX_BUFFER_ID];
     mutex_t bufferWriteLock;
+    uint32_t bufferWriteCnt;            // Total buffer creates & writes, any change invalidates tile hashes
 
     // Ram arena
     uint8_t* ram0BufferBase;            // Ram0 base
@@ -107,6 +188,13 @@ typedef struct GpuState_t
     void* jitMethods[0xff];             // exported methods into jitted cmds (eg. calling sqrt from shader code, must call method table due to code relocation)
 
     void* globalState3D[2];              // 3D extention state 
+
+    // Tilemap caches, 0 unless GpuInitOptions_t.enableTilemapCaches
+    struct GpuTilemapCaches_t* tilemapCaches;
+
+    // Scratch
+    uint8_t* scratch[GPU_MAX_INSTANCES]; // Per instance scratch arenas, bound by gpu_init_instance
+    uint32_t scratchSz;                 // Size of each scratch arena
 } GpuState_t;
 
 
@@ -115,6 +203,7 @@ typedef struct GpuState_t
 typedef struct GpuInstance_t
 {
     uint32_t instanceId;
+    uint32_t subTileId;                 // tile slice, shared buffer cmds only run on slice 0
 
     // current stats
     bool inFrame;
@@ -123,12 +212,19 @@ typedef struct GpuInstance_t
     uint32_t tileMaxTime;
 
     GpuFrameStats_t frameStats;
-    GpuFrameProfile frameProfile;
+    GpuFrameProfile* frameProfile;    // profiler output, required when enableProfiler (owner clears)
     bool enableProfiler;
+    uint32_t profileNestedCycles;     // cycles of cmds run inside the current cmd, excluded from its profile
     bool debugCommandUploads;
 
     // render state    
     struct TileFrameBuffer_t* fb0;    // bound composite tile
+    bool trustedCmds;                 // list passed gpu_trust_cmds_list, dispatch cmdsUnchecked
+
+    // scratch arena, bump allocated & reset every gpu_begin_frame
+    uint8_t* scratchBase;
+    uint32_t scratchSz;
+    uint32_t scratchOffset;
 
     // debug
     bool enableDebuger;
@@ -141,7 +237,7 @@ typedef struct GpuInstance_t
 // gpu api
 uint8_t* gpu_malloc(uint32_t sz);                                               // gpu related malloc
 GpuState_t* gpu_init(struct GpuInitOptions_t* options);                         // Init gpu
-void gpu_init_instance(GpuState_t* state, GpuInstance_t* job, uint32_t instanceId);  // Init gpu instance eg. per core
+void gpu_init_instance(GpuState_t* state, GpuInstance_t* job, uint32_t instanceId);  // Init gpu instance eg. per core, instanceId < GPU_MAX_INSTANCES selects scratch arena
 void gpu_deinit(GpuState_t* gpu);                                                // De-init gpu
 void gpu_reset(GpuState_t* state, uint8_t cmds, uint8_t buffers, uint8_t stats); // Reset gpu state
 void gpu_register_cmd(GpuState_t* state, GpuCmdInfo_t info);                    // Register gpu cmd
@@ -150,34 +246,126 @@ void gpu_begin_frame(GpuState_t* state, GpuInstance_t* job, uint32_t frameId);
 void gpu_end_frame(GpuState_t* state, GpuInstance_t* job); 
 void gpu_clear_error_stats(GpuState_t* state, GpuInstance_t* job);              // prepare tile run, clear error counters
 void gpu_run_tile(GpuState_t* state, GpuInstance_t* job, GpuCommandList_t* commands, TileFrameBuffer_t* tile);    // Render command into tile
+bool gpu_build_tile_bins(GpuCommandList_t* commands, GpuTileBins_t* bins, uint32_t tileCnt);         // Bin commands by tile cull mask, returns false when bins overflow
+void gpu_run_tile_binned(GpuState_t* state, GpuInstance_t* job, GpuCommandList_t* commands, const GpuTileBins_t* bins, TileFrameBuffer_t* tile);   // Render binned commands into tile, falls back to gpu_run_tile if bins invalid
+uint32_t gpu_hash_tile_cmds(GpuState_t* state, GpuCommandList_t* commands, const GpuTileBins_t* bins, uint32_t tileId, uint32_t seed);  // Hash cmds rendered into tile & buffer write count, equal hash renders equal tile
 void gpu_dump_cmds(GpuState_t* state, GpuCommandList_t* commands);
 bool gpu_validate_cmds_list(GpuState_t* state, GpuCommandList_t* list, struct GpuValidationOutput_t* info);  // Check commands valid and output crc, returns true if validation passed
 bool gpu_validate_cmds_listlist(GpuState_t* state, GpuCommandListList_t* listlist, struct GpuValidationOutput_t* info);  // Check commands valid and output crc, returns true if validation passed
+bool gpu_trust_cmds_list(GpuState_t* state, GpuCommandList_t* list);           // Validate list & referenced buffers once, true when tiles may run it with unchecked cmds
+void gpu_prepare_cmds_list(GpuState_t* state, GpuCommandList_t* list);         // Run cmd prepare hooks once before tiles, tiles must not be running
 int gpu_register_cmd_jit(GpuState_t* state, uint8_t cmdId, uint8_t bufferId);   // Register gpu buffer as cmd jit code
 uint16_t gpu_calc_tile_cull_mask(int32_t y, int32_t h);                         // Calc tile mask for cmd y pos and height
 uint16_t gpu_calc_tile_cull_mask_line(int32_t y0, int32_t y1);                  // Calc tile mask coverage over line, any order of y allowed
+void gpu_set_cmd_cull_rect(GpuCmd_Header* header, int32_t x, int32_t y, int32_t w, int32_t h);  // Set header screen bounds, skips cmd in gpu_run_tile when outside tile
+uint16_t gpu_calc_cmd_tile_mask(GpuCmd_Header* header, uint16_t allTilesMask);   // Tiles cmd renders into from header cull mask & rect
 void gpu_diag_buffers(GpuState_t* state);                                       // dump buffer diags
 struct GpuBufferInfo* gpu_get_buffer_by_id(GpuState_t* state, uint32_t id);
 void gpu_debug_dump_state(GpuState_t* state, bool dumpBufferData);              // Dump entire gpu state to UART
 void gpu_dump_buffer_state(GpuState_t* state, uint32_t bufferId);               // Dump buffer
 void gpu_bind_fbo(GpuState_t* state, GpuInstance_t* job, struct TileFrameBuffer_t* fb0); // Bind tile frame buffer
+bool gpu_validate_cmd_list_buffer(GpuState_t* state, struct GpuBufferInfo* buffer, struct GpuValidationOutput_t* info);   // Validate ETextureFormat_CmdList buffer & count cmds on upload, result cached in buffer cmdListValid
+void gpu_run_tile_cmd_list_buffer(GpuState_t* state, GpuInstance_t* job, struct GpuBufferInfo* buffer, TileFrameBuffer_t* tile, int16_t offsetX, int16_t offsetY);  // Render validated cmd list buffer into tile
+void gpu_profile_add_cmd(GpuFrameProfile* profile, uint8_t cmdId, uint32_t cycles);  // Add cmd exec cycles to profile
+void gpu_profile_merge(GpuFrameProfile* dst, const GpuFrameProfile* src);       // Accumulate profile eg. per tile slice into frame
+void* gpu_scratch_alloc(GpuInstance_t* job, uint32_t sz);                       // Alloc 4 byte aligned tile temporary from instance scratch, returns 0 when full
+uint32_t gpu_scratch_mark(GpuInstance_t* job);                                  // Current scratch offset, pass to gpu_scratch_release to free allocs made after it
+void gpu_scratch_release(GpuInstance_t* job, uint32_t mark);                    // Release scratch allocs back to mark ( LIFO )
 
 // gpu utils
 uint8_t* gpu_malloc(uint32_t sz);
 void gpu_free(uint8_t* ptr);
 struct Col16_t gpu_col_from_rgba_hex(uint32_t rgb);
-struct Col16_t gpu_col_from_rgbf(float r, float g, float b);
+struct Col16_t gpu_col_from_rgbf(float r, float g, float b);            // float helpers, not for per pixel/cmd paths see gpu_col_*_uint16
 uint16_t gpu_col_to_uint16(struct Col16_t col);
 struct Col16_t gpu_col_from_rgb565(uint16_t r, uint16_t g, uint16_t b);
 struct Col16_t gpu_col_from_uint16(uint16_t coli);
 struct ColRGBF_t gpu_col_to_rgbf(struct Col16_t col);
 struct ColRGBF_t gpu_coli_to_rgbf(uint16_t coli);
 struct Col16_t gpu_rgbf_to_col(struct ColRGBF_t colf);
-uint16_t gpu_col_add_uint16(uint16_t a, uint16_t b);
 void gpu_print_validator_error(struct GpuValidationOutput_t* info);
 void gpu_validate_assert(const char* message, const char* file, unsigned line, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info);
 void gpu_error(struct GpuState_t* gpu, struct GpuInstance_t* job, int errorCode, const char* desc);
 
+// integer RGB565 colour helpers, safe for per pixel use (no float conversions)
+static inline uint16_t gpu_col_pack_uint16(uint32_t r, uint32_t g, uint32_t b)  // pack 5:6:5 components
+{
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static inline void gpu_col_unpack_uint16(uint16_t c, uint8_t* r, uint8_t* g, uint8_t* b) // unpack 5:6:5 components
+{
+    *r = c >> 11;
+    *g = (c >> 5) & COL16_MAX_G;
+    *b = c & COL16_MAX_B;
+}
+
+static inline uint16_t gpu_col_from_rgb888_uint16(uint32_t rgb)    // 0xRRGGBB to RGB565, truncates as gpu_col_from_rgbf
+{
+    return gpu_col_pack_uint16(
+        (((rgb >> 16) & 0xff) * COL16_MAX_R) / 255,
+        (((rgb >> 8) & 0xff) * COL16_MAX_G) / 255,
+        ((rgb & 0xff) * COL16_MAX_B) / 255);
+}
+
+static inline uint32_t gpu_col_to_rgb888_uint16(uint16_t c)        // RGB565 to 0xRRGGBB, truncates as gpu_col_to_rgbf * 255
+{
+    uint8_t r, g, b;
+    gpu_col_unpack_uint16(c, &r, &g, &b);
+    return (((r * 255) / COL16_MAX_R) << 16)
+        | (((g * 255) / COL16_MAX_G) << 8)
+        | ((b * 255) / COL16_MAX_B);
+}
+
+static inline uint16_t gpu_col_add_uint16(uint16_t a, uint16_t b)  // saturating add
+{
+    uint32_t r = (a >> 11) + (b >> 11);
+    uint32_t g = ((a >> 5) & COL16_MAX_G) + ((b >> 5) & COL16_MAX_G);
+    uint32_t bl = (a & COL16_MAX_B) + (b & COL16_MAX_B);
+    return gpu_col_pack_uint16(
+        r < COL16_MAX_R ? r : COL16_MAX_R,
+        g < COL16_MAX_G ? g : COL16_MAX_G,
+        bl < COL16_MAX_B ? bl : COL16_MAX_B);
+}
+
+static inline uint16_t gpu_col_lerp_uint16(uint16_t a, uint16_t b, uint32_t t)    // a -> b, t in [0..32]
+{
+    uint32_t x = (a | ((uint32_t)a << 16)) & 0x07e0f81f;
+    uint32_t y = (b | ((uint32_t)b << 16)) & 0x07e0f81f;
+    x += (y - x) * t >> 5;
+    x &= 0x07e0f81f;
+    return (uint16_t)(x | (x >> 16));
+}
+
+static inline uint16_t gpu_col_blend_uint16(uint16_t fg, uint16_t bg, uint8_t alpha)  // alpha blend fg over bg, alpha in [0..255]
+{
+    return gpu_col_lerp_uint16(bg, fg, alpha >> 3);
+}
+
+static inline uint16_t gpu_col_mul_uint16(uint16_t a, uint16_t b)  // per channel modulate, white is identity
+{
+    return gpu_col_pack_uint16(
+        ((a >> 11) * (b >> 11)) / COL16_MAX_R,
+        (((a >> 5) & COL16_MAX_G) * ((b >> 5) & COL16_MAX_G)) / COL16_MAX_G,
+        ((a & COL16_MAX_B) * (b & COL16_MAX_B)) / COL16_MAX_B);
+}
+
+static inline uint16_t gpu_col_scale_uint16(uint16_t c, uint32_t s)  // brightness scale, s is 8.8 fixed point & saturates
+{
+    uint32_t r = ((c >> 11) * s) >> 8;
+    uint32_t g = (((c >> 5) & COL16_MAX_G) * s) >> 8;
+    uint32_t b = ((c & COL16_MAX_B) * s) >> 8;
+    return gpu_col_pack_uint16(
+        r < COL16_MAX_R ? r : COL16_MAX_R,
+        g < COL16_MAX_G ? g : COL16_MAX_G,
+        b < COL16_MAX_B ? b : COL16_MAX_B);
+}
+
+static inline uint16_t gpu_col_tint_uint16(uint16_t c, uint16_t tint, uint8_t amount)   // modulate by tint, amount in [0..255]
+{
+    return gpu_col_blend_uint16(gpu_col_mul_uint16(c, tint), c, amount);
+}
+
 // simulated flash 
 #ifdef PICOCOM_SDL
     int save_and_disable_interrupts();
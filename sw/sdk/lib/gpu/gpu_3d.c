@@ -21,6 +21,8 @@ void gpu_cmd_impl_BeginFrameTile3D_impl(struct GpuState_t* gpu, struct GpuInstan
 void gpu_cmd_impl_SetShader3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
 void gpu_cmd_impl_SetMatrix3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
 void gpu_cmd_impl_DrawMesh3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
+void gpu_cmd_impl_DrawMesh3D_unchecked_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
+bool gpu_cmd_impl_DrawMesh3D_check_buffers(const struct GpuState_t* gpu, struct GpuCmd_Header* header);
 void gpu_cmd_impl_DrawTriSolid_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
 void gpu_cmd_impl_DrawTriTex_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
 void gpu_cmd_impl_LookAt3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
@@ -128,9 +130,19 @@ void gpu_cmd_impl_DrawMesh3D(struct GpuState_t* gpu, struct GpuInstance_t* job,
 }
 
 
+void gpu_cmd_impl_DrawMesh3D_unchecked(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    gpu_cmd_impl_DrawMesh3D_unchecked_impl( gpu, job, header, fb );
+}
+
+
 bool validate_gpu_cmd_impl_DrawMesh3D(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
 {    
     GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_DrawMesh3D));                
+    if(info->checkBufferState)
+    {
+        GPU_VALIDATE_ASSERT(gpu_cmd_impl_DrawMesh3D_check_buffers(gpu, header));
+    }
     return true;
 }
 
@@ -196,7 +208,7 @@ void gpu_init_commands_3d(GpuState_t* state)
     gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="EGPUCMD_BeginFrameTile3D", .id=EGPUCMD_BeginFrameTile3D, .cmd=gpu_cmd_impl_BeginFrameTile3D, .validator=validate_gpu_cmd_impl_BeginFrameTile3D, .toString=toString_gpu_cmd_impl_BeginFrameTile3D});
     gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="EGPUCMD_SetShader3D", .id=EGPUCMD_SetShader3D, .cmd=gpu_cmd_impl_SetShader3D, .validator=validate_gpu_cmd_impl_SetShader3D, .toString=toString_gpu_cmd_impl_SetShader3D});
     gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="EGPUCMD_SetMatrix3D", .id=EGPUCMD_SetMatrix3D, .cmd=gpu_cmd_impl_SetMatrix3D, .validator=validate_gpu_cmd_impl_SetMatrix3D, .toString=toString_gpu_cmd_impl_SetMatrix3D});
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="EGPUCMD_DrawMesh3D", .id=EGPUCMD_DrawMesh3D, .cmd=gpu_cmd_impl_DrawMesh3D, .validator=validate_gpu_cmd_impl_DrawMesh3D, .toString=toString_gpu_cmd_impl_DrawMesh3D});        
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="EGPUCMD_DrawMesh3D", .id=EGPUCMD_DrawMesh3D, .cmd=gpu_cmd_impl_DrawMesh3D, .cmdUnchecked=gpu_cmd_impl_DrawMesh3D_unchecked, .validator=validate_gpu_cmd_impl_DrawMesh3D, .toString=toString_gpu_cmd_impl_DrawMesh3D});        
     gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="EGPUCMD_DrawTriTex", .id=EGPUCMD_DrawTriTex, .cmd=gpu_cmd_impl_DrawTriTex, .validator=validate_gpu_cmd_impl_DrawTriTex, .toString=toString_gpu_cmd_impl_DrawTriTex});    
     gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="EGPUCMD_LookAt3D", .id=EGPUCMD_LookAt3D, .cmd=gpu_cmd_impl_LookAt3D, .validator=validate_gpu_cmd_impl_LookAt3D, .toString=toString_gpu_cmd_impl_LookAt3D});    
 }
\ No newline at end of file
@@ -13,6 +13,8 @@ extern "C" {
     void gpu_cmd_impl_SetShader3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
     void gpu_cmd_impl_SetMatrix3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
     void gpu_cmd_impl_DrawMesh3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
+    void gpu_cmd_impl_DrawMesh3D_unchecked_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
+    bool gpu_cmd_impl_DrawMesh3D_check_buffers(const struct GpuState_t* gpu, struct GpuCmd_Header* header);
     void gpu_cmd_impl_DrawTriSolid_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
     void gpu_cmd_impl_DrawTriTex_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
     void gpu_cmd_impl_LookAt3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb);
@@ -124,78 +126,58 @@ void gpu_cmd_impl_BeginFrameTile3D_impl(struct GpuState_t* gpu, struct GpuInstan
 
 
 //
-//
-void gpu_cmd_impl_DrawMesh3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+// Mesh buffer refs checked per cmd, or once in the trusted list pre-pass
+static const char* draw_mesh3d_check_buffers(struct GpuState_t* gpu, const struct GPUCMD_DrawMesh3D* cmd)
 {
-    GpuState3DImpl* impl = (GpuState3DImpl*)gpu->globalState3D[job->instanceId];
-    if( !impl )
-    {
-        gpu_error(gpu, job, EGpuErrorCode_General, "!State3D");
-        return;      
-    }
-
-    struct GPUCMD_DrawMesh3D* cmd = (GPUCMD_DrawMesh3D*)header;
     if(cmd->meshBufferId >= GPU_MAX_BUFFER_ID)
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "cmd->meshBufferId >= GPU_MAX_BUFFER_ID");
-        return;
-    }
+        return "cmd->meshBufferId >= GPU_MAX_BUFFER_ID";
 
     struct GpuBufferInfo* meshBuffer = &gpu->buffers[cmd->meshBufferId];
     struct GpuMesh3DBufferInfo* meshInfo = (GpuMesh3DBufferInfo*)meshBuffer->basePtr;
     if( !meshInfo )
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "!meshInfo");
-        return;  
-    }
+        return "!meshInfo";
 
     GpuBufferInfo* vertBuffer = gpu_get_buffer_by_id( gpu, meshInfo->vertsBufferId );
     if( !vertBuffer )
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "!vertBuffer");
-        return;
-    }    
+        return "!vertBuffer";
     if( (vertBuffer->w * sizeof(float) * 3) != vertBuffer->size)       // Vec3 * numVerts
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "cmd->vertsBufferId invalid size");
-        return;
-    }
+        return "cmd->vertsBufferId invalid size";
 
     GpuBufferInfo* texCoordsBuffer = gpu_get_buffer_by_id( gpu, meshInfo->texCoordsBufferId );
     if( !texCoordsBuffer )
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "!texCoordsBuffer");
-        return;
-    }    
+        return "!texCoordsBuffer";
     if( (texCoordsBuffer->w * sizeof(float) * 2) != texCoordsBuffer->size)       // Vec2* numTexCoords
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "cmd->texCoordsBufferId invalid size");
-        return;
-    }
+        return "cmd->texCoordsBufferId invalid size";
     
     GpuBufferInfo* normalsBuffer = gpu_get_buffer_by_id( gpu, meshInfo->normalsBufferId );
     if( !normalsBuffer )
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "!normalsBuffer");
-        return;
-    }    
+        return "!normalsBuffer";
     if( (normalsBuffer->w * sizeof(float) * 3) != normalsBuffer->size)       // Vec2* numNormals
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "cmd->normalsBufferId invalid size");
-        return;
-    }
+        return "cmd->normalsBufferId invalid size";
         
     GpuBufferInfo* facesBuffer = gpu_get_buffer_by_id( gpu, meshInfo->facesBufferId );
     if( !facesBuffer )
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "!facesBuffer");
-        return;
-    }    
+        return "!facesBuffer";
     if( (facesBuffer->w * sizeof(uint16_t)) != facesBuffer->size)       // Vec2* numNormals
-    {
-        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "cmd->facesBufferId invalid size");
-        return;
-    }
+        return "cmd->facesBufferId invalid size";
+
+    return 0;
+}
+
+
+bool gpu_cmd_impl_DrawMesh3D_check_buffers(const struct GpuState_t* gpu, struct GpuCmd_Header* header)
+{
+    return draw_mesh3d_check_buffers((struct GpuState_t*)gpu, (GPUCMD_DrawMesh3D*)header) == 0;
+}
+
+
+static void draw_mesh3d_exec(struct GpuState_t* gpu, GpuState3DImpl* impl, const struct GPUCMD_DrawMesh3D* cmd)
+{
+    struct GpuMesh3DBufferInfo* meshInfo = (GpuMesh3DBufferInfo*)gpu->buffers[cmd->meshBufferId].basePtr;
+    GpuBufferInfo* vertBuffer = &gpu->buffers[meshInfo->vertsBufferId];
+    GpuBufferInfo* texCoordsBuffer = &gpu->buffers[meshInfo->texCoordsBufferId];
+    GpuBufferInfo* normalsBuffer = &gpu->buffers[meshInfo->normalsBufferId];
+    GpuBufferInfo* facesBuffer = &gpu->buffers[meshInfo->facesBufferId];
 
     const tgx::Image<tgx::RGB565> img((void*)0, 0, 0);
     GpuBufferInfo* textureBuffer = gpu_get_buffer_by_id( gpu, cmd->textureBufferId );
@@ -231,6 +213,42 @@ void gpu_cmd_impl_DrawMesh3D_impl(struct GpuState_t* gpu, struct GpuInstance_t*
 }
 
 
+//
+//
+void gpu_cmd_impl_DrawMesh3D_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    GpuState3DImpl* impl = (GpuState3DImpl*)gpu->globalState3D[job->instanceId];
+    if( !impl )
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "!State3D");
+        return;      
+    }
+
+    struct GPUCMD_DrawMesh3D* cmd = (GPUCMD_DrawMesh3D*)header;
+    const char* error = draw_mesh3d_check_buffers(gpu, cmd);
+    if( error )
+    {
+        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, error);
+        return;
+    }
+
+    draw_mesh3d_exec(gpu, impl, cmd);
+}
+
+
+void gpu_cmd_impl_DrawMesh3D_unchecked_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    GpuState3DImpl* impl = (GpuState3DImpl*)gpu->globalState3D[job->instanceId];
+    if( !impl )
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "!State3D");
+        return;      
+    }
+
+    draw_mesh3d_exec(gpu, impl, (GPUCMD_DrawMesh3D*)header);
+}
+
+
 //
 //
 void gpu_cmd_impl_DrawTriSolid_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
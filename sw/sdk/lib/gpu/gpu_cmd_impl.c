@@ -28,18 +28,6 @@ int modi(int a, int b)
     return res < 0 ? res + b : res;
 }
 
-// CREDIT: https://stackoverflow.com/questions/18937701/combining-two-16-bits-rgb-colors-with-alpha-blending
-static inline uint16_t ALPHA_BLIT16_565(uint32_t fg, uint32_t bg, uint8_t alpha) {
-    // Alpha converted from [0..255] to [0..31]
-    uint32_t ALPHA = alpha >> 3;     
-    fg = (fg | fg << 16) & 0x07e0f81f;
-    bg = (bg | bg << 16) & 0x07e0f81f;
-    bg += (fg - bg) * ALPHA >> 5;
-    bg &= 0x07e0f81f;
-    return (uint16_t)(bg | bg >> 16);
-}
-
-
 // 
 // tilemaps
 static int tileLookup[256];
@@ -96,6 +84,27 @@ void initTilemap() {
 }
 
 
+// Decal tile & mass variant per chunk cell, only depend on cell so rng runs once
+static uint8_t tileDecalLookup[GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ];
+static uint16_t tileVariantLookup[GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ];     // First cell rng % GPU_TILE_PHASE_MOD
+void initTileDecals() {
+    for(int tileY=0;tileY<GPU_TILEMAP_TILE_SZ;tileY++)
+    {
+        for(int tileX=0;tileX<GPU_TILEMAP_TILE_SZ;tileX++)
+        {
+            struct pseudo_random_t rng;
+            pseudo_random_init(&rng); 
+            pseudo_random_offset_seed(&rng, tileX, tileY); 
+        
+            uint32_t u0 = pseudo_random_uint(&rng);
+            uint32_t u1 = pseudo_random_uint(&rng);
+            tileDecalLookup[tileX + (tileY * GPU_TILEMAP_TILE_SZ)] = (u0 % 8) + ((u1 % 8) * 8);
+            tileVariantLookup[tileX + (tileY * GPU_TILEMAP_TILE_SZ)] = u0 % GPU_TILE_PHASE_MOD;
+        }
+    }
+}
+
+
 /** Gpu assert helper */
 void gpu_validate_assert(const char* message, const char* file, unsigned line, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
 {
@@ -237,7 +246,7 @@ void gpu_cmd_impl_FillRectCol(struct GpuState_t* gpu, struct GpuInstance_t* job,
 
                     int index = localX + pixelRowStride;
 
-                    pixels[index] = ALPHA_BLIT16_565(cmd->col, pixels[index], cmd->a);   
+                    pixels[index] = gpu_col_blend_uint16(cmd->col, pixels[index], cmd->a);   
                     if(fb->attr)
                         fb->attr[index] = cmd->a;                           
                 }
@@ -257,8 +266,8 @@ bool validate_gpu_cmd_impl_FillRectCol(const struct GpuState_t* gpu, struct GpuC
 
 void gpu_cmd_impl_CreateBuffer_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* tile)
 {
-    // ignore buffer cmds on core 1
-    if(job->instanceId > 0)
+    // ignore buffer cmds on tile slices, run once per tile
+    if(job->subTileId > 0)
         return;
             
     if(tile->tileId != 0)
@@ -266,6 +275,7 @@ void gpu_cmd_impl_CreateBuffer_impl(struct GpuState_t* gpu, struct GpuInstance_t
         gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "Buffer create can only occur on sycned tile 0");
         return;        
     }
+    gpu->bufferWriteCnt++;
 
     // Update buffer info in gpu state
     struct GPUCMD_CreateBuffer* cmd = (GPUCMD_CreateBuffer*)header;
@@ -349,6 +359,9 @@ void gpu_cmd_impl_CreateBuffer_impl(struct GpuState_t* gpu, struct GpuInstance_t
     buffer->w = cmd->w;
     buffer->h = cmd->h;
     buffer->locked = 0;
+    buffer->cmdListValid = false;
+    buffer->cmdListCnt = 0;
+    buffer->writeCnt++;     // recreated, invalidates caches keyed by writeCnt
 }
 
 
@@ -389,8 +402,8 @@ bool toString_gpu_cmd_impl_CreateBuffer(const struct GpuState_t* gpu, struct Gpu
 
 void gpu_cmd_impl_WriteBufferData_impl(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* tile)
 {
-    // ignore buffer cmds on core 1
-    if(job->instanceId > 0)
+    // ignore buffer cmds on tile slices, run once per tile
+    if(job->subTileId > 0)
         return;
 
     struct GPUCMD_WriteBufferData* cmd = (GPUCMD_WriteBufferData*)header;
@@ -423,6 +436,8 @@ void gpu_cmd_impl_WriteBufferData_impl(struct GpuState_t* gpu, struct GpuInstanc
 
     // stats
     buffer->writeCnt++;
+    gpu->bufferWriteCnt++;
+    buffer->cmdListValid = false;
     if(cmd->flags & EGPUCMD_WriteBufferDataFlags_finalPage)
     {
         buffer->finalWriteCnt++;
@@ -482,6 +497,15 @@ void gpu_cmd_impl_WriteBufferData_impl(struct GpuState_t* gpu, struct GpuInstanc
             gpu_error(gpu, job, EGpuErrorCode_General, "Invalid arena");
             return;
     }
+
+    // cmd lists validated once written, flash readable after final page, earlier pages may be partial lists
+    bool finalPage = (cmd->flags & EGPUCMD_WriteBufferDataFlags_finalPage) != 0;
+    if(buffer->textureFormat == ETextureFormat_CmdList && (buffer->arenaId != EGPUBufferArena_Flash0 || finalPage))
+    {
+        struct GpuValidationOutput_t info = {0};
+        if(!gpu_validate_cmd_list_buffer(gpu, buffer, &info) && finalPage)
+            gpu_error(gpu, job, EGpuErrorCode_General, "Cmd list failed validation");
+    }
 }
 
 
@@ -534,620 +558,1625 @@ bool toString_gpu_cmd_impl_WriteBufferData(const struct GpuState_t* gpu, struct
 }
 
 
-void gpu_cmd_impl_BlitRect16bpp(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+//
+// Span blitter
+// Rows are clipped once per command and split into runs of linear source texels, each run is
+// handed to a blend specific span kernel which pairs pixels into 32-bit accesses.
+
+/** Source addressing along a blit row */
+enum EBlitSpanWrap
 {
-    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
-    uint16_t* pixels = (uint16_t*)fb->pixelsData;
-    if(cmd->bufferId >= GPU_MAX_BUFFER_ID)
+    EBlitSpanWrap_None,         // Flip only
+    EBlitSpanWrap_Repeat,       // Flip then repeat on buffer width ( EBlendMode_None )
+    EBlitSpanWrap_RepeatPre,    // Repeat on buffer width then flip, rows repeat on buffer height ( EBlendMode_Add )
+};
+
+
+/** Span kernel per blend mode */
+enum EBlitSpanOp
+{
+    EBlitSpanOp_Copy16,
+    EBlitSpanOp_Pal8,
+    EBlitSpanOp_Key16,
+    EBlitSpanOp_TintAdd16,
+    EBlitSpanOp_FillMasked16,
+    EBlitSpanOp_ColkeyAlpha16,
+    EBlitSpanOp_Add16,
+    EBlitSpanOp_Key8,           // Affine only, 8bpp src keyed on index
+    EBlitSpanOp_FillMasked8,
+};
+
+
+/** Run of dst pixels reading a linear source range */
+typedef struct BlitSpanRun_t
+{
+    uint32_t n;             // Dst pixel count
+    uint32_t srcIndex;      // First source texel in row
+    int step;               // Source step, 1 or -1 when flipped
+    bool valid;             // Source texels inside buffer
+} BlitSpanRun_t;
+
+
+/** Resolve run starting at dst x, matches per pixel addressing of the original blitter 
+ * ( flip, repeat & buffer->size rejection ) so output is identical.
+*/
+static inline BlitSpanRun_t blit_span_next_run(const struct GPUCMD_BlitRect* cmd, const struct GpuBufferInfo* buffer, int wrap, int x, uint32_t remain)
+{
+    BlitSpanRun_t run;
+    bool flip = cmd->flags & EDrawTextureFlags_FlippedX;
+    uint32_t bw = buffer->w;
+    uint32_t k = x + cmd->srcX;
+    uint32_t v;
+    uint32_t len;
+
+    switch(wrap)
     {
-        gpu_error(gpu, job, EGpuErrorCode_General, "");
-        return;
+    case EBlitSpanWrap_Repeat:
+        if(flip)
+        {
+            v = (bw - k - 1) % bw;
+            len = v + 1;
+        }
+        else
+        {
+            v = k % bw;
+            len = bw - v;
+        }
+        break;
+    case EBlitSpanWrap_RepeatPre:
+    {
+        // texel bw is sampled once before wrapping
+        uint32_t u = k > bw ? k % bw : k;
+        if(flip)
+        {
+            v = bw - u - 1;
+            len = u == bw ? 1 : bw - u;
+        }
+        else
+        {
+            v = u;
+            len = k > bw ? bw - u : bw - u + 1;
+        }
+        break;
+    }
+    default:
+        if(flip)
+        {
+            v = bw - k - 1;
+            len = k < bw ? bw - k : remain;
+        }
+        else
+        {
+            v = k;
+            len = remain;
+        }
+        break;
     }
 
-    struct GpuBufferInfo* buffer = gpu_get_buffer_by_id(gpu, cmd->bufferId);
-    if(!buffer)
+    if(len > remain)
+        len = remain;
+
+    run.srcIndex = v;
+    run.step = flip ? -1 : 1;
+    run.valid = v < buffer->size;
+    if(!flip)
     {
-        gpu_error(gpu, job, EGpuErrorCode_General, "");
-        return;
+        // Ascending, rest of run rejected once past size
+        if(run.valid && len > buffer->size - v)
+            len = buffer->size - v;
     }
+    else if(!run.valid)
+    {
+        // Descending, reject until back inside size
+        if(v - buffer->size < len)
+            len = v - buffer->size + 1;
+    }
+    run.n = len;
+    return run;
+}
 
-    int pixelBaseX = cmd->dstX;
-    int pixelBaseY = cmd->dstY - fb->y;
-    int pixelStartY = 0;   
-    if(pixelBaseY < 0)
-        pixelStartY = -pixelBaseY;
 
-    // calc start pixel X ()
-    int pixelStartX = 0;   
-    if(pixelBaseX < 0)
-        pixelStartX = -pixelBaseX;
-    int pixelCntY = cmd->h;
-    
-    // check for repeat modes
-    bool wrapMode = false;
-    if(cmd->w > buffer->w)
+/** Store 2 pixels in a single 32-bit write, dst must be word aligned ( little endian ) */
+static inline void blit_span_store2(uint16_t* dst, uint16_t c0, uint16_t c1)
+{
+    *(uint32_t*)dst = (uint32_t)c0 | ((uint32_t)c1 << 16);
+}
+
+
+static inline void blit_span_copy16(uint16_t* dst, const uint16_t* src, int step, uint32_t n)
+{
+    if(n && ((uintptr_t)dst & 2))
     {
-        wrapMode = true;
+        *dst++ = *src;
+        src += step;
+        n--;
     }
 
-    switch (cmd->blendMode)
+    if(step > 0 && !((uintptr_t)src & 2))
     {
-    case EBlendMode_None:
+        // src & dst aligned, straight word copy
+        uint32_t* dst32 = (uint32_t*)dst;
+        const uint32_t* src32 = (const uint32_t*)src;
+        for(; n >= 2; n -= 2)
+            *dst32++ = *src32++;
+        dst = (uint16_t*)dst32;
+        src = (const uint16_t*)src32;
+    }
+    else
     {
-        if(buffer->textureFormat == ETextureFormat_RGB16)
-        {
-            uint16_t* srcBuffer = (uint16_t*)buffer->basePtr;
+        for(; n >= 2; n -= 2, dst += 2, src += step * 2)
+            blit_span_store2(dst, src[0], src[step]);
+    }
 
-            for(int y=pixelStartY;y<pixelCntY;y++)
-            {
-                // calc start pixel Y
-                int localY = pixelBaseY + y;
-                if(localY >= fb->h)
-                    break;
-                int pixelRowStride = (localY * fb->w);
-                int pixelCntX = cmd->w;
-                int baseRowOffset = ( ( y + cmd->srcY ) * buffer->w );
+    if(n)
+        *dst = *src;
+}
 
-                for(int x=pixelStartX;x<pixelCntX;x++)
-                {                    
-                    int localX = pixelBaseX + x;
-                    if(localX >= fb->w)
-                        break;
 
-                    int index = localX + pixelRowStride;
+static inline void blit_span_pal8(uint16_t* dst, const uint8_t* src, int step, const uint16_t* pal, uint32_t n)
+{
+    if(n && ((uintptr_t)dst & 2))
+    {
+        *dst++ = pal[*src];
+        src += step;
+        n--;
+    }
+
+    if(step > 0 && !((uintptr_t)src & 3))
+    {
+        // 4 indices per source read
+        for(; n >= 4; n -= 4, dst += 4, src += 4)
+        {
+            uint32_t cids = *(const uint32_t*)src;
+            blit_span_store2(dst, pal[cids & 0xff], pal[(cids >> 8) & 0xff]);
+            blit_span_store2(dst + 2, pal[(cids >> 16) & 0xff], pal[cids >> 24]);
+        }
+    }
 
-                    uint32_t srcIndexX = x + cmd->srcX;
+    for(; n >= 2; n -= 2, dst += 2, src += step * 2)
+        blit_span_store2(dst, pal[src[0]], pal[src[step]]);
 
-                    if(cmd->flags & EDrawTextureFlags_FlippedX)
-                        srcIndexX = buffer->w - srcIndexX - 1;
-                    
-                    // wrap mode
-                    if(wrapMode)
-                        srcIndexX = srcIndexX % buffer->w;
+    if(n)
+        *dst = pal[*src];
+}
 
-                    if( srcIndexX >= buffer->size)
-                        continue;
 
-                    uint16_t c = srcBuffer[ srcIndexX + baseRowOffset ];
+static inline uint16_t blit_span_key_shade(int op, uint16_t c, uint16_t arg)
+{
+    switch(op)
+    {
+    case EBlitSpanOp_TintAdd16:
+        return gpu_col_add_uint16(c, arg);
+    case EBlitSpanOp_FillMasked16:
+        return arg;
+    default:
+        return c;
+    }
+}
+
 
-                    pixels[ index ] = c;
-                    if(fb->attr)
-                        fb->attr[index] = cmd->writeAlpha;
-                }
-            }   
-        } 
-        else if(buffer->textureFormat == ETextureFormat_8BPP)
+/** Color keyed span, op selects copy, tint add or fill */
+static inline void blit_span_key16(uint16_t* dst, uint8_t* attr, const uint16_t* src, int step, uint32_t n, int op, uint16_t colKey, uint16_t arg, uint8_t attrValue)
+{
+    uint32_t i = 0;
+    if(n && ((uintptr_t)dst & 2))
+    {
+        if(src[0] != colKey)
         {
-            // Get palette
-            struct GpuBufferInfo* palBuffer = gpu_get_buffer_by_id(gpu, cmd->palBufferId);
-            if(!palBuffer)
-            {
-                gpu_error(gpu, job, EGpuErrorCode_General, ""); 
-                return;
-            }
+            dst[0] = blit_span_key_shade(op, src[0], arg);
+            if(attr)
+                attr[0] = attrValue;
+        }
+        i = 1;
+    }
 
-            // Ensure valid palette format
-            if(palBuffer->textureFormat != ETextureFormat_RGB16)
+    for(; i + 1 < n; i += 2)
+    {
+        uint16_t c0 = src[(int)i * step];
+        uint16_t c1 = src[(int)(i + 1) * step];
+        if(c0 != colKey && c1 != colKey)
+        {
+            blit_span_store2(dst + i, blit_span_key_shade(op, c0, arg), blit_span_key_shade(op, c1, arg));
+            if(attr)
             {
-                gpu_error(gpu, job, EGpuErrorCode_General, ""); 
-                return;
+                attr[i] = attrValue;
+                attr[i + 1] = attrValue;
             }
+            continue;
+        }
 
-            //uint8_t* srcBuffer = (uint16_t*)buffer->basePtr; // Compiled on gcc, changed on wasm might break things ?
-            uint8_t* srcBuffer = (uint8_t*)buffer->basePtr;
+        if(c0 != colKey)
+        {
+            dst[i] = blit_span_key_shade(op, c0, arg);
+            if(attr)
+                attr[i] = attrValue;
+        }
+        if(c1 != colKey)
+        {
+            dst[i + 1] = blit_span_key_shade(op, c1, arg);
+            if(attr)
+                attr[i + 1] = attrValue;
+        }
+    }
 
-            for(int y=pixelStartY;y<pixelCntY;y++)
-            {
-                // calc start pixel Y
-                int localY = pixelBaseY + y;
-                if(localY >= fb->h)
-                    break;
-                int pixelRowStride = (localY * fb->w);
-                int pixelCntX = cmd->w;
-                int baseRowOffset = ( ( y + cmd->srcY ) * buffer->w );
+    if(i < n)
+    {
+        uint16_t c = src[(int)i * step];
+        if(c != colKey)
+        {
+            dst[i] = blit_span_key_shade(op, c, arg);
+            if(attr)
+                attr[i] = attrValue;
+        }
+    }
+}
 
-                for(int x=pixelStartX;x<pixelCntX;x++)
-                {                    
-                    int localX = pixelBaseX + x;
-                    if(localX >= fb->w)
-                        break;
 
-                    int index = localX + pixelRowStride;
+/** Palette keyed span, fills with fillCol when no palette */
+static inline void blit_span_key8(uint16_t* dst, uint8_t* attr, const uint8_t* src, uint32_t n, uint16_t colKey, const uint16_t* pal, uint16_t fillCol)
+{
+    uint32_t i = 0;
+    if(n && ((uintptr_t)dst & 2))
+    {
+        if(src[0] != colKey)
+        {
+            dst[0] = pal ? pal[src[0]] : fillCol;
+            if(attr)
+                attr[0] = 0xff;
+        }
+        i = 1;
+    }
+
+    for(; i + 1 < n; i += 2)
+    {
+        uint8_t cid0 = src[i];
+        uint8_t cid1 = src[i + 1];
+        if(cid0 != colKey && cid1 != colKey)
+        {
+            if(pal)
+                blit_span_store2(dst + i, pal[cid0], pal[cid1]);
+            else
+                blit_span_store2(dst + i, fillCol, fillCol);
+            if(attr)
+            {
+                attr[i] = 0xff;
+                attr[i + 1] = 0xff;
+            }
+            continue;
+        }
 
-                    uint32_t srcIndexX = x + cmd->srcX;
+        if(cid0 != colKey)
+        {
+            dst[i] = pal ? pal[cid0] : fillCol;
+            if(attr)
+                attr[i] = 0xff;
+        }
+        if(cid1 != colKey)
+        {
+            dst[i + 1] = pal ? pal[cid1] : fillCol;
+            if(attr)
+                attr[i + 1] = 0xff;
+        }
+    }
 
-                    if(cmd->flags & EDrawTextureFlags_FlippedX)
-                        srcIndexX = buffer->w - srcIndexX - 1;
-                    
-                    // wrap mode
-                    if(wrapMode)
-                        srcIndexX = srcIndexX % buffer->w;
+    if(i < n && src[i] != colKey)
+    {
+        dst[i] = pal ? pal[src[i]] : fillCol;
+        if(attr)
+            attr[i] = 0xff;
+    }
+}
 
-                    if( srcIndexX >= buffer->size)
-                        continue;
 
-                    uint8_t cid = srcBuffer[ srcIndexX + baseRowOffset ];
+/** Alpha blend non zero texels, alpha also written to attr */
+static inline void blit_span_colkey_alpha16(uint16_t* dst, uint8_t* attr, const uint16_t* src, int step, uint32_t n, uint8_t alpha)
+{
+    uint32_t i = 0;
+    if(n && ((uintptr_t)dst & 2))
+    {
+        if(src[0])
+        {
+            dst[0] = gpu_col_blend_uint16(src[0], dst[0], alpha);
+            if(attr)
+                attr[0] = alpha;
+        }
+        i = 1;
+    }
 
-                    uint16_t c = ((uint16_t*)palBuffer->basePtr)[cid]; 
+    for(; i + 1 < n; i += 2)
+    {
+        uint16_t c0 = src[(int)i * step];
+        uint16_t c1 = src[(int)(i + 1) * step];
+        if(c0 && c1)
+        {
+            uint32_t bg = *(uint32_t*)(dst + i);
+            blit_span_store2(dst + i, gpu_col_blend_uint16(c0, bg & 0xffff, alpha), gpu_col_blend_uint16(c1, bg >> 16, alpha));
+            if(attr)
+            {
+                attr[i] = alpha;
+                attr[i + 1] = alpha;
+            }
+            continue;
+        }
 
-                    pixels[ index ] = c;
-                    if(fb->attr)
-                        fb->attr[index] = cmd->writeAlpha;
-                }
-            }  
+        if(c0)
+        {
+            dst[i] = gpu_col_blend_uint16(c0, dst[i], alpha);
+            if(attr)
+                attr[i] = alpha;
         }
-        break;
-    }        
-    case EBlendMode_ColorKey:
+        if(c1)
+        {
+            dst[i + 1] = gpu_col_blend_uint16(c1, dst[i + 1], alpha);
+            if(attr)
+                attr[i + 1] = alpha;
+        }
+    }
+
+    if(i < n)
     {
-        if(buffer->textureFormat == ETextureFormat_RGB16)
+        uint16_t c = src[(int)i * step];
+        if(c)
         {
-            uint16_t* srcBuffer = (uint16_t*)buffer->basePtr;
+            dst[i] = gpu_col_blend_uint16(c, dst[i], alpha);
+            if(attr)
+                attr[i] = alpha;
+        }
+    }
+}
 
-            for(int y=pixelStartY;y<pixelCntY;y++)
-            {
-                // calc start pixel Y
-                int localY = pixelBaseY + y;
-                if(localY >= fb->h)
-                    break;
-                int pixelRowStride = (localY * fb->w);
-                int pixelCntX = cmd->w;
-                int baseRowOffset = ( ( y + cmd->srcY ) * buffer->w );
 
-                for(int x=pixelStartX;x<pixelCntX;x++)
-                {                    
-                    int localX = pixelBaseX + x;
-                    if(localX >= fb->w)
-                        break;
+static inline void blit_span_add16(uint16_t* dst, const uint16_t* src, int step, uint32_t n)
+{
+    uint32_t i = 0;
+    if(n && ((uintptr_t)dst & 2))
+    {
+        dst[0] = gpu_col_add_uint16(dst[0], src[0]);
+        i = 1;
+    }
 
-                    int index = localX + pixelRowStride;
+    for(; i + 1 < n; i += 2)
+    {
+        uint32_t bg = *(uint32_t*)(dst + i);
+        blit_span_store2(dst + i, 
+            gpu_col_add_uint16(bg & 0xffff, src[(int)i * step]), 
+            gpu_col_add_uint16(bg >> 16, src[(int)(i + 1) * step]));
+    }
 
-                    uint32_t srcIndexX = x + cmd->srcX;
+    if(i < n)
+        dst[i] = gpu_col_add_uint16(dst[i], src[(int)i * step]);
+}
 
-                    if(cmd->flags & EDrawTextureFlags_FlippedX)
-                        srcIndexX = buffer->w - srcIndexX - 1;
-                        
-                    if( srcIndexX >= buffer->size)
-                        continue;
 
-                    uint16_t c = srcBuffer[ srcIndexX + baseRowOffset ];
+/** Walk clipped rows of a 16bpp blit, dispatching each source run to the op span kernel */
+static void blit_span_rows16(const struct GPUCMD_BlitRect* cmd, const struct GpuBufferInfo* buffer, const uint16_t* pal, TileFrameBuffer_t* fb, int op, int wrap)
+{
+    uint16_t* pixels = (uint16_t*)fb->pixelsData;
 
-                    if(c != cmd->colKey)
-                    {
-                        pixels[ index ] = c;
-                        if(fb->attr)
-                            fb->attr[index] = cmd->writeAlpha;
-                    }
-                }
-            }   
-        } 
-        else if(buffer->textureFormat == ETextureFormat_8BPP)
-        {
-            uint8_t* srcBuffer = (uint8_t*)buffer->basePtr;
+    // Repeat modes divide by buffer size
+    if(wrap != EBlitSpanWrap_None && !buffer->w)
+        return;
+    if(wrap == EBlitSpanWrap_RepeatPre && !buffer->h)
+        return;
 
-            // Get palette
-            struct GpuBufferInfo* palBuffer = gpu_get_buffer_by_id(gpu, cmd->palBufferId);
-            if(!palBuffer)
-            {
-                gpu_error(gpu, job, EGpuErrorCode_General, ""); 
-                return;
-            }
+    // Clip once per command, x range shared by all rows
+    int pixelBaseX = cmd->dstX;
+    int pixelBaseY = cmd->dstY - fb->y;
+    int xBegin = pixelBaseX < 0 ? -pixelBaseX : 0;
+    int xEnd = MIN((int)cmd->w, (int)fb->w - pixelBaseX);
+    int yBegin = pixelBaseY < 0 ? -pixelBaseY : 0;
+    int yEnd = MIN((int)cmd->h, (int)fb->h - pixelBaseY);
+    if(xBegin >= xEnd)
+        return;
 
-            // Ensure valid palette format
-            if(palBuffer->textureFormat != ETextureFormat_RGB16)
-            {
-                gpu_error(gpu, job, EGpuErrorCode_General, ""); 
-                return;
-            }
+    for(int y=yBegin;y<yEnd;y++)
+    {
+        int fillY = y;
+        if(wrap == EBlitSpanWrap_RepeatPre && fillY >= buffer->h)
+            fillY = fillY % buffer->h;
 
-            for(int y=0;y<cmd->h;y++)
+        int rowIndex = ((pixelBaseY + y) * fb->w) + pixelBaseX;
+        int baseRowOffset = ( fillY + cmd->srcY ) * buffer->w;
+
+        for(int x=xBegin;x<xEnd;)
+        {
+            BlitSpanRun_t run = blit_span_next_run(cmd, buffer, wrap, x, xEnd - x);
+            if(run.valid)
             {
-                int localY = (cmd->dstY + y) - fb->y + cmd->srcY;
-                if(localY < 0 || localY >= fb->h)
-                    continue;
+                int index = rowIndex + x;
+                uint16_t* dst = pixels + index;
+                uint8_t* attr = fb->attr ? fb->attr + index : 0;
+                uint32_t srcIndex = run.srcIndex + baseRowOffset;
 
-                for(int x=0;x<cmd->w;x++)
-                {                    
-                    int localX = cmd->dstX + x;
-                    if(localX < 0 || localX >= fb->w)
-                        continue;
-                    
-                    int index = localX + (localY*fb->w);
-            
-                    uint8_t cid = srcBuffer[x + cmd->srcX  + ((y+ cmd->srcY)*buffer->w)];
-                    if(cid != cmd->colKey)
-                    {
-                        uint16_t c = ((uint16_t*)palBuffer->basePtr)[cid];                
-                        pixels[ index ] = c;
-                        if(fb->attr)
-                            fb->attr[index] = 0xff;       
-                    }
+                switch(op)
+                {
+                case EBlitSpanOp_Copy16:
+                    blit_span_copy16(dst, (const uint16_t*)buffer->basePtr + srcIndex, run.step, run.n);
+                    if(attr)
+                        memset(attr, cmd->writeAlpha, run.n);
+                    break;
+                case EBlitSpanOp_Pal8:
+                    blit_span_pal8(dst, buffer->basePtr + srcIndex, run.step, pal, run.n);
+                    if(attr)
+                        memset(attr, cmd->writeAlpha, run.n);
+                    break;
+                case EBlitSpanOp_Key16:
+                case EBlitSpanOp_TintAdd16:
+                case EBlitSpanOp_FillMasked16:
+                    blit_span_key16(dst, attr, (const uint16_t*)buffer->basePtr + srcIndex, run.step, run.n, op, cmd->colKey, cmd->palBufferId, cmd->writeAlpha);
+                    break;
+                case EBlitSpanOp_ColkeyAlpha16:
+                    blit_span_colkey_alpha16(dst, attr, (const uint16_t*)buffer->basePtr + srcIndex, run.step, run.n, (uint8_t)cmd->colKey);
+                    break;
+                case EBlitSpanOp_Add16:
+                    blit_span_add16(dst, (const uint16_t*)buffer->basePtr + srcIndex, run.step, run.n);
+                    if(attr)
+                        memset(attr, cmd->writeAlpha, run.n);
+                    break;
                 }
             }
+            x += run.n;
         }
-        break;
     }
+}
+
+
+/** Walk clipped rows of an 8bpp source onto an 8bpp target, colour indices are written as is */
+static void blit_span_rows8(const struct GPUCMD_BlitRect* cmd, const struct GpuBufferInfo* buffer, TileFrameBuffer_t* fb)
+{
+    uint8_t* pixels = (uint8_t*)fb->pixelsData;
+
+    // Clip once per command, x range shared by all rows
+    int pixelBaseX = cmd->dstX;
+    int pixelBaseY = cmd->dstY - fb->y;
+    int xBegin = pixelBaseX < 0 ? -pixelBaseX : 0;
+    int xEnd = MIN((int)cmd->w, (int)fb->w - pixelBaseX);
+    int yBegin = pixelBaseY < 0 ? -pixelBaseY : 0;
+    int yEnd = MIN((int)cmd->h, (int)fb->h - pixelBaseY);
+    if(xBegin >= xEnd)
+        return;
+
+    uint8_t colKey = (uint8_t)cmd->colKey;
+    uint8_t fillCol = (uint8_t)cmd->palBufferId;
+    for(int y=yBegin;y<yEnd;y++)
+    {
+        uint8_t* row = pixels + ((pixelBaseY + y) * fb->w) + pixelBaseX;
+        int baseRowOffset = ( y + cmd->srcY ) * buffer->w;
+
+        for(int x=xBegin;x<xEnd;)
+        {
+            BlitSpanRun_t run = blit_span_next_run(cmd, buffer, EBlitSpanWrap_None, x, xEnd - x);
+            if(run.valid)
+            {
+                uint8_t* dst = row + x;
+                const uint8_t* src = buffer->basePtr + run.srcIndex + baseRowOffset;
+                int step = run.step;
+                uint32_t n = run.n;
+
+                switch(cmd->blendMode)
+                {
+                case EBlendMode_None:
+                    if(step == 1)
+                        memcpy(dst, src, n);
+                    else
+                    {
+                        for(uint32_t i=0;i<n;i++)
+                            dst[i] = src[-(int)i];
+                    }
+                    break;
+                case EBlendMode_ColorKey:
+                    for(uint32_t i=0;i<n;i++)
+                    {
+                        uint8_t c = src[(int)i * step];
+                        if(c != colKey)
+                            dst[i] = c;
+                    }
+                    break;
+                case EBlendMode_FillMasked:
+                    for(uint32_t i=0;i<n;i++)
+                    {
+                        if(src[(int)i * step] != colKey)
+                            dst[i] = fillCol;
+                    }
+                    break;
+                case EBlendMode_Add:
+                    // saturating index add, meaningful for ramp palettes
+                    for(uint32_t i=0;i<n;i++)
+                    {
+                        uint32_t c = dst[i] + src[(int)i * step];
+                        dst[i] = c > 0xff ? 0xff : c;
+                    }
+                    break;
+                }
+            }
+            x += run.n;
+        }
+    }
+}
+
+
+/** Palette keyed rows, dst row is offset by srcY and attr forced to 0xff as per the 8bpp path */
+static void blit_span_rows_key8(const struct GPUCMD_BlitRect* cmd, const struct GpuBufferInfo* buffer, const uint16_t* pal, uint16_t fillCol, TileFrameBuffer_t* fb)
+{
+    uint16_t* pixels = (uint16_t*)fb->pixelsData;
+    int pixelBaseX = cmd->dstX;
+    int pixelBaseY = cmd->dstY - fb->y + cmd->srcY;
+    int xBegin = pixelBaseX < 0 ? -pixelBaseX : 0;
+    int xEnd = MIN((int)cmd->w, (int)fb->w - pixelBaseX);
+    int yBegin = pixelBaseY < 0 ? -pixelBaseY : 0;
+    int yEnd = MIN((int)cmd->h, (int)fb->h - pixelBaseY);
+    if(xBegin >= xEnd)
+        return;
+
+    for(int y=yBegin;y<yEnd;y++)
+    {
+        int index = ((pixelBaseY + y) * fb->w) + pixelBaseX + xBegin;
+        const uint8_t* src = buffer->basePtr + xBegin + cmd->srcX + ((y + cmd->srcY) * buffer->w);
+        blit_span_key8(pixels + index, fb->attr ? fb->attr + index : 0, src, xEnd - xBegin, cmd->colKey, pal, fillCol);
+    }
+}
+
+
+/** Fetch RGB16 palette for 8bpp blits */
+static const uint16_t* blit_get_palette(struct GpuState_t* gpu, struct GpuInstance_t* job, const struct GPUCMD_BlitRect* cmd)
+{
+    struct GpuBufferInfo* palBuffer = gpu_get_buffer_by_id(gpu, cmd->palBufferId);
+    if(!palBuffer)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, ""); 
+        return 0;
+    }
+
+    // Ensure valid palette format
+    if(palBuffer->textureFormat != ETextureFormat_RGB16)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, ""); 
+        return 0;
+    }
+
+    return (const uint16_t*)palBuffer->basePtr;
+}
+
+
+/** Blend mode & texture format resolved to a row walker once per cmd ( or per sprite batch ) */
+typedef struct BlitRectOp_t
+{
+    bool rowsKey8;          // blit_span_rows_key8 else blit_span_rows16
+    bool needsPal;
+    bool skip;              // Unsupported format, nothing drawn
+    int op;                 // EBlitSpanOp
+    int wrap;               // EBlitSpanWrap, None op repeats when wider than buffer
+    uint16_t fillCol;       // Key8 fill when no pal
+} BlitRectOp_t;
+
+
+static bool blit_rect16_resolve(const struct GPUCMD_BlitRect* cmd, const struct GpuBufferInfo* buffer, BlitRectOp_t* out)
+{
+    bool isRGB16 = buffer->textureFormat == ETextureFormat_RGB16;
+    bool is8bpp = buffer->textureFormat == ETextureFormat_8BPP;
+    memset(out, 0, sizeof(*out));
+    out->skip = !isRGB16 && !is8bpp;
+
+    switch (cmd->blendMode)
+    {
+    case EBlendMode_None:
+        out->op = isRGB16 ? EBlitSpanOp_Copy16 : EBlitSpanOp_Pal8;
+        out->needsPal = is8bpp;
+        break;
+    case EBlendMode_ColorKey:
     case EBlendMode_ColorKeyTintAdd:
+        // NOTE: tint not applied to palette textures
+        out->op = cmd->blendMode == EBlendMode_ColorKey ? EBlitSpanOp_Key16 : EBlitSpanOp_TintAdd16;
+        out->rowsKey8 = is8bpp;
+        out->needsPal = is8bpp;
+        break;
+    case EBlendMode_FillMasked:
+        out->op = EBlitSpanOp_FillMasked16;
+        out->rowsKey8 = is8bpp;
+        out->fillCol = cmd->palBufferId;    // palBufferId used as col
+        break;
+    case EBlendMode_ColkeyAlpha:
+        out->op = EBlitSpanOp_ColkeyAlpha16;
+        out->skip = !isRGB16;
+        break;
+    case EBlendMode_Add:
+        if(isRGB16)
+        {
+            out->op = EBlitSpanOp_Add16;
+            out->wrap = EBlitSpanWrap_RepeatPre;
+            break;
+        }
+    default:
+        return false;
+    }
+    return true;
+}
+
+
+static inline void blit_rect16_exec(const struct GPUCMD_BlitRect* cmd, const struct GpuBufferInfo* buffer, const BlitRectOp_t* blit, const uint16_t* pal, TileFrameBuffer_t* fb)
+{
+    if(blit->skip)
+        return;
+
+    if(blit->rowsKey8)
+    {
+        blit_span_rows_key8(cmd, buffer, pal, blit->fillCol, fb);
+        return;
+    }
+
+    // check for repeat modes
+    int wrap = blit->wrap;
+    if((blit->op == EBlitSpanOp_Copy16 || blit->op == EBlitSpanOp_Pal8) && cmd->w > buffer->w)
+        wrap = EBlitSpanWrap_Repeat;
+    blit_span_rows16(cmd, buffer, pal, fb, blit->op, wrap);
+}
+
+
+/** Buffer refs checked by gpu_trust_cmds_list, unchecked 16bpp blits index buffers directly */
+static bool blit_rect16_buffers_valid(const struct GpuState_t* gpu, const struct GPUCMD_BlitRect* cmd)
+{
+    const struct GpuBufferInfo* buffer = gpu_get_buffer_by_id((struct GpuState_t*)gpu, cmd->bufferId);
+    if(!buffer)
+        return false;
+
+    BlitRectOp_t blit;
+    if(blit_rect16_resolve(cmd, buffer, &blit) && blit.needsPal)
+    {
+        const struct GpuBufferInfo* palBuffer = gpu_get_buffer_by_id((struct GpuState_t*)gpu, cmd->palBufferId);
+        if(!palBuffer || palBuffer->textureFormat != ETextureFormat_RGB16)
+            return false;
+    }
+    return true;
+}
+
+
+/** 16bpp blit for trusted lists, buffers checked once by blit_rect16_buffers_valid */
+static void blit_rect16_unchecked(struct GpuState_t* gpu, struct GpuInstance_t* job, const struct GPUCMD_BlitRect* cmd, TileFrameBuffer_t* fb)
+{
+    const struct GpuBufferInfo* buffer = &gpu->buffers[cmd->bufferId];
+
+    BlitRectOp_t blit;
+    if(!blit_rect16_resolve(cmd, buffer, &blit))
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit blend mode");
+        return;            
+    }
+
+    const uint16_t* pal = blit.needsPal ? (const uint16_t*)gpu->buffers[cmd->palBufferId].basePtr : 0;
+    blit_rect16_exec(cmd, buffer, &blit, pal, fb);
+}
+
+
+void gpu_cmd_impl_BlitRect16bpp(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
+    if(cmd->bufferId >= GPU_MAX_BUFFER_ID)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
+
+    struct GpuBufferInfo* buffer = gpu_get_buffer_by_id(gpu, cmd->bufferId);
+    if(!buffer)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
+
+    BlitRectOp_t blit;
+    if(!blit_rect16_resolve(cmd, buffer, &blit))
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit blend mode");
+        return;            
+    }
+
+    const uint16_t* pal = 0;
+    if(blit.needsPal)
+    {
+        pal = blit_get_palette(gpu, job, cmd);
+        if(!pal)
+            return;
+    }
+
+    blit_rect16_exec(cmd, buffer, &blit, pal, fb);
+}
+
+
+void gpu_cmd_impl_BlitRect8bpp(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
+    if(cmd->bufferId >= GPU_MAX_BUFFER_ID)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
+
+    struct GpuBufferInfo* buffer = gpu_get_buffer_by_id(gpu, cmd->bufferId);
+    if(!buffer)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
+
+    switch (cmd->blendMode)
+    {
+    case EBlendMode_None:
+    case EBlendMode_ColorKey:
+    case EBlendMode_FillMasked:
+    case EBlendMode_Add:
+    {
+        // Only palette indexed sources map onto 8bpp targets
+        if(buffer->textureFormat == ETextureFormat_8BPP)
+            blit_span_rows8(cmd, buffer, fb);
+        break;
+    }                
+    default:
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit blend mode");
+        return;            
+    }
+}
+
+
+void gpu_cmd_impl_BlitRect(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    if(fb->colorDepth == EColorDepth_BGR565)
+    {
+        gpu_cmd_impl_BlitRect16bpp( gpu, job, header, fb);
+    }
+    else if(fb->colorDepth == EColorDepth_8BPP)
+    {
+        gpu_cmd_impl_BlitRect8bpp( gpu, job, header, fb);
+    }
+
+}
+
+
+void gpu_cmd_impl_BlitRect_unchecked(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    if(fb->colorDepth == EColorDepth_BGR565)
+    {
+        blit_rect16_unchecked( gpu, job, (GPUCMD_BlitRect*)header, fb);
+    }
+    else if(fb->colorDepth == EColorDepth_8BPP)
+    {
+        gpu_cmd_impl_BlitRect8bpp( gpu, job, header, fb);
+    }
+}
+
+
+bool validate_gpu_cmd_impl_BlitRect(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
+{
+    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
+
+    GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_BlitRect));            
+    GPU_VALIDATE_ASSERT(cmd->bufferId < GPU_MAX_BUFFER_ID);
+        
+    info->extraArg0 = cmd->bufferId;
+    //GPU_VALIDATE_ASSERT(info->buffersCreated[cmd->bufferId]);    // NOTE: buffers are global state
+    GPU_VALIDATE_ASSERT(cmd->w < 1024);
+    GPU_VALIDATE_ASSERT(cmd->h < 1024);
+    if(info->checkBufferState)
+    {
+        GPU_VALIDATE_ASSERT(blit_rect16_buffers_valid(gpu, cmd));
+    }
+        
+    return true;
+}
+
+
+bool toString_gpu_cmd_impl_BlitRect(const struct GpuState_t* gpu, struct GpuCmd_Header* header, char* buff, uint32_t buffSz)
+{
+    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
+    sprintf(buff, "bufferId:%d, srcX:%d, srcY:%d, dstX:%d, dstY:%d, w:%d, h:%d, colKey:%d, palBid:%d", 
+            cmd->bufferId,
+            cmd->srcX,
+            cmd->srcY,    
+            cmd->dstX,
+            cmd->dstY,
+            cmd->w,
+            cmd->h,      
+            cmd->colKey,
+            cmd->palBufferId);   
+    return true;
+}
+
+/** Sprite batch shared blit state, per sprite rect filled by sprite_batch_exec16 */
+static void sprite_batch_init_blit_cmd(const struct GPUCMD_DrawSpriteBatch* cmd, struct GPUCMD_BlitRect* blitCmd)
+{
+    memset(blitCmd, 0, sizeof(*blitCmd));
+    blitCmd->bufferId = cmd->bufferId;
+    blitCmd->colKey = cmd->colKey;
+    blitCmd->palBufferId = cmd->palBufferId;
+    blitCmd->blendMode = cmd->blendMode;
+    blitCmd->a = GPU_ATTR_ALPHA_MASK;
+    blitCmd->writeAlpha = cmd->writeAlpha;
+}
+
+
+static void sprite_batch_exec16(const struct GPUCMD_DrawSpriteBatch* cmd, struct GPUCMD_BlitRect* blitCmd, const struct GpuBufferInfo* buffer, const BlitRectOp_t* blit, const uint16_t* pal, TileFrameBuffer_t* fb)
+{
+    int fbY0 = fb->y;
+    int fbY1 = fb->y + fb->h;
+    for(int i=0;i<cmd->instanceCnt;i++)
+    {
+        const GpuSpriteInstance* sprite = &cmd->instances[i];
+        if(sprite->y >= fbY1 || sprite->y + sprite->h <= fbY0)
+            continue;
+
+        blitCmd->dstX = sprite->x;
+        blitCmd->dstY = sprite->y;
+        blitCmd->srcX = sprite->srcX;
+        blitCmd->srcY = sprite->srcY;
+        blitCmd->w = sprite->w;
+        blitCmd->h = sprite->h;
+        blitCmd->flags = sprite->flags;
+        blit_rect16_exec(blitCmd, buffer, blit, pal, fb);
+    }
+}
+
+
+void gpu_cmd_impl_DrawSpriteBatch(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    struct GPUCMD_DrawSpriteBatch* cmd = (GPUCMD_DrawSpriteBatch*)header;
+    if(fb->colorDepth == EColorDepth_8BPP)
+    {
+        // 8bpp targets go through the regular blitter per sprite
+        struct GPUCMD_BlitRect blitCmd = {0};
+        blitCmd.header = *header;
+        blitCmd.header.sz = sizeof(GPUCMD_BlitRect);
+        blitCmd.bufferId = cmd->bufferId;
+        blitCmd.colKey = cmd->colKey;
+        blitCmd.palBufferId = cmd->palBufferId;
+        blitCmd.blendMode = cmd->blendMode;
+        blitCmd.a = GPU_ATTR_ALPHA_MASK;
+        blitCmd.writeAlpha = cmd->writeAlpha;
+        for(int i=0;i<cmd->instanceCnt;i++)
+        {
+            const GpuSpriteInstance* sprite = &cmd->instances[i];
+            blitCmd.dstX = sprite->x;
+            blitCmd.dstY = sprite->y;
+            blitCmd.srcX = sprite->srcX;
+            blitCmd.srcY = sprite->srcY;
+            blitCmd.w = sprite->w;
+            blitCmd.h = sprite->h;
+            blitCmd.flags = sprite->flags;
+            gpu_cmd_impl_BlitRect8bpp(gpu, job, &blitCmd.header, fb);
+        }
+        return;
+    }
+    else if(fb->colorDepth != EColorDepth_BGR565)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported sprite batch target");
+        return;
+    }
+
+    struct GpuBufferInfo* buffer = gpu_get_buffer_by_id(gpu, cmd->bufferId);
+    if(!buffer)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
+
+    // shared state resolved once for all sprites
+    struct GPUCMD_BlitRect blitCmd;
+    sprite_batch_init_blit_cmd(cmd, &blitCmd);
+
+    BlitRectOp_t blit;
+    if(!blit_rect16_resolve(&blitCmd, buffer, &blit))
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit blend mode");
+        return;            
+    }
+
+    const uint16_t* pal = 0;
+    if(blit.needsPal)
+    {
+        pal = blit_get_palette(gpu, job, &blitCmd);
+        if(!pal)
+            return;
+    }
+
+    sprite_batch_exec16(cmd, &blitCmd, buffer, &blit, pal, fb);
+}
+
+
+void gpu_cmd_impl_DrawSpriteBatch_unchecked(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    if(fb->colorDepth != EColorDepth_BGR565)
+    {
+        gpu_cmd_impl_DrawSpriteBatch(gpu, job, header, fb);
+        return;
+    }
+
+    struct GPUCMD_DrawSpriteBatch* cmd = (GPUCMD_DrawSpriteBatch*)header;
+    const struct GpuBufferInfo* buffer = &gpu->buffers[cmd->bufferId];
+
+    struct GPUCMD_BlitRect blitCmd;
+    sprite_batch_init_blit_cmd(cmd, &blitCmd);
+
+    BlitRectOp_t blit;
+    if(!blit_rect16_resolve(&blitCmd, buffer, &blit))
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit blend mode");
+        return;            
+    }
+
+    const uint16_t* pal = blit.needsPal ? (const uint16_t*)gpu->buffers[cmd->palBufferId].basePtr : 0;
+    sprite_batch_exec16(cmd, &blitCmd, buffer, &blit, pal, fb);
+}
+
+
+bool validate_gpu_cmd_impl_DrawSpriteBatch(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
+{
+    struct GPUCMD_DrawSpriteBatch* cmd = (GPUCMD_DrawSpriteBatch*)header;
+
+    GPU_VALIDATE_ASSERT(header->sz >= sizeof(GPUCMD_DrawSpriteBatch));            
+    GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_DrawSpriteBatch) + (cmd->instanceCnt * sizeof(GpuSpriteInstance)));            
+    GPU_VALIDATE_ASSERT(cmd->bufferId < GPU_MAX_BUFFER_ID);
+        
+    info->extraArg0 = cmd->bufferId;
+    if(info->checkBufferState)
+    {
+        struct GPUCMD_BlitRect blitCmd;
+        sprite_batch_init_blit_cmd(cmd, &blitCmd);
+        GPU_VALIDATE_ASSERT(blit_rect16_buffers_valid(gpu, &blitCmd));
+    }
+    return true;
+}
+
+
+bool toString_gpu_cmd_impl_DrawSpriteBatch(const struct GpuState_t* gpu, struct GpuCmd_Header* header, char* buff, uint32_t buffSz)
+{
+    struct GPUCMD_DrawSpriteBatch* cmd = (GPUCMD_DrawSpriteBatch*)header;
+    sprintf(buff, "bufferId:%d, colKey:%d, palBid:%d, blendMode:%d, instanceCnt:%d", 
+            cmd->bufferId,
+            cmd->colKey,
+            cmd->palBufferId,
+            cmd->blendMode,
+            cmd->instanceCnt);   
+    return true;
+}
+
+//
+// Affine blitter
+// Each dst row is clipped against the src rect once by solving the linear u/v edges for x, the 
+// span inside is then stepped in 16.16 fixed point with no per texel bounds checks.
+
+/** Floor/ceil divide, d > 0 */
+static inline int64_t blit_affine_floor_div(int64_t n, int64_t d)
+{
+    return n >= 0 ? n / d : -((-n + d - 1) / d);
+}
+
+
+static inline int64_t blit_affine_ceil_div(int64_t n, int64_t d)
+{
+    return -blit_affine_floor_div(-n, d);
+}
+
+
+/** Narrow dst range [x0, x1) so base + step*x stays within [0, limit) */
+static inline void blit_affine_clip(int64_t base, int64_t step, int64_t limit, int* x0, int* x1)
+{
+    int64_t lo;
+    int64_t hi;
+    if(step == 0)
+    {
+        if(base < 0 || base >= limit)
+            *x1 = *x0;
+        return;
+    }
+
+    if(step > 0)
+    {
+        lo = blit_affine_ceil_div(-base, step);
+        hi = blit_affine_floor_div(limit - 1 - base, step);
+    }
+    else
+    {
+        lo = blit_affine_ceil_div(base - (limit - 1), -step);
+        hi = blit_affine_floor_div(base, -step);
+    }
+
+    if(lo > *x0)
+        *x0 = lo > *x1 ? *x1 : (int)lo;
+    if(hi + 1 < *x1)
+        *x1 = hi + 1 < *x0 ? *x0 : (int)(hi + 1);
+}
+
+
+/** u & v are 16.16 inside src for all n texels, stepped unsigned as the step after the last texel can leave int32 range */
+static void blit_affine_span16(uint16_t* dst, uint8_t* attr, const uint16_t* src, uint32_t bw, uint32_t u, uint32_t v, uint32_t du, uint32_t dv, uint32_t n, int op, const struct GPUCMD_BlitRectAffine* cmd)
+{
+    uint16_t colKey = cmd->colKey;
+    uint16_t arg = cmd->palBufferId;
+    uint8_t writeAlpha = cmd->writeAlpha;
+
+    switch(op)
+    {
+    case EBlitSpanOp_Copy16:
+        for(uint32_t i=0;i<n;i++, u += du, v += dv)
+            dst[i] = src[(u >> 16) + ((v >> 16) * bw)];
+        if(attr)
+            memset(attr, writeAlpha, n);
+        break;
+    case EBlitSpanOp_Key16:
+    case EBlitSpanOp_TintAdd16:
+    case EBlitSpanOp_FillMasked16:
+        for(uint32_t i=0;i<n;i++, u += du, v += dv)
+        {
+            uint16_t c = src[(u >> 16) + ((v >> 16) * bw)];
+            if(c == colKey)
+                continue;
+            dst[i] = blit_span_key_shade(op, c, arg);
+            if(attr)
+                attr[i] = writeAlpha;
+        }
+        break;
+    case EBlitSpanOp_ColkeyAlpha16:
     {
-        if(buffer->textureFormat == ETextureFormat_RGB16)
+        uint8_t alpha = (uint8_t)colKey;
+        for(uint32_t i=0;i<n;i++, u += du, v += dv)
         {
-            uint16_t* srcBuffer = (uint16_t*)buffer->basePtr;
+            uint16_t c = src[(u >> 16) + ((v >> 16) * bw)];
+            if(!c)
+                continue;
+            dst[i] = gpu_col_blend_uint16(c, dst[i], alpha);
+            if(attr)
+                attr[i] = alpha;
+        }
+        break;
+    }
+    case EBlitSpanOp_Add16:
+        for(uint32_t i=0;i<n;i++, u += du, v += dv)
+            dst[i] = gpu_col_add_uint16(dst[i], src[(u >> 16) + ((v >> 16) * bw)]);
+        if(attr)
+            memset(attr, writeAlpha, n);
+        break;
+    }
+}
 
-            for(int y=pixelStartY;y<pixelCntY;y++)
-            {
-                // calc start pixel Y
-                int localY = pixelBaseY + y;
-                if(localY >= fb->h)
-                    break;
-                int pixelRowStride = (localY * fb->w);
-                int pixelCntX = cmd->w;
-                int baseRowOffset = ( ( y + cmd->srcY ) * buffer->w );
 
-                for(int x=pixelStartX;x<pixelCntX;x++)
-                {                    
-                    int localX = pixelBaseX + x;
-                    if(localX >= fb->w)
-                        break;
+/** 8bpp source, pal lookup or keyed on colKey index ( fill col when no pal ) */
+static void blit_affine_span8(uint16_t* dst, uint8_t* attr, const uint8_t* src, uint32_t bw, uint32_t u, uint32_t v, uint32_t du, uint32_t dv, uint32_t n, int op, const uint16_t* pal, const struct GPUCMD_BlitRectAffine* cmd)
+{
+    switch(op)
+    {
+    case EBlitSpanOp_Pal8:
+        for(uint32_t i=0;i<n;i++, u += du, v += dv)
+            dst[i] = pal[src[(u >> 16) + ((v >> 16) * bw)]];
+        if(attr)
+            memset(attr, cmd->writeAlpha, n);
+        break;
+    default:
+        for(uint32_t i=0;i<n;i++, u += du, v += dv)
+        {
+            uint8_t cid = src[(u >> 16) + ((v >> 16) * bw)];
+            if(cid == cmd->colKey)
+                continue;
+            dst[i] = pal ? pal[cid] : cmd->palBufferId;
+            if(attr)
+                attr[i] = 0xff;
+        }
+        break;
+    }
+}
 
-                    int index = localX + pixelRowStride;
 
-                    uint32_t srcIndexX = x + cmd->srcX;
+/** Blend mode -> span op for texture format, matches gpu_cmd_impl_BlitRect16bpp. -1 when unsupported, ColkeyAlpha & Add need RGB16 */
+static int blit_affine_resolve_op(uint8_t blendMode, uint8_t textureFormat)
+{
+    bool isRGB16 = textureFormat == ETextureFormat_RGB16;
+    if(!isRGB16 && textureFormat != ETextureFormat_8BPP)
+        return -1;
 
-                    if(cmd->flags & EDrawTextureFlags_FlippedX)
-                        srcIndexX = buffer->w - srcIndexX - 1;
-                        
-                    if( srcIndexX >= buffer->size)
-                        continue;
+    switch (blendMode)
+    {
+    case EBlendMode_None:
+        return isRGB16 ? EBlitSpanOp_Copy16 : EBlitSpanOp_Pal8;
+    case EBlendMode_ColorKey:
+        return isRGB16 ? EBlitSpanOp_Key16 : EBlitSpanOp_Key8;
+    case EBlendMode_ColorKeyTintAdd:
+        return isRGB16 ? EBlitSpanOp_TintAdd16 : EBlitSpanOp_Key8;    // NOTE: tint not applied to palette textures
+    case EBlendMode_FillMasked:
+        return isRGB16 ? EBlitSpanOp_FillMasked16 : EBlitSpanOp_FillMasked8;
+    case EBlendMode_ColkeyAlpha:
+        return isRGB16 ? EBlitSpanOp_ColkeyAlpha16 : -1;
+    case EBlendMode_Add:
+        return isRGB16 ? EBlitSpanOp_Add16 : -1;
+    default:
+        return -1;
+    }
+}
 
-                    uint16_t c = srcBuffer[ srcIndexX + baseRowOffset ];
 
-                    if(c != cmd->colKey)
-                    {
-                        c = gpu_col_add_uint16( c, cmd->palBufferId );   
+void gpu_cmd_impl_BlitRectAffine(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    struct GPUCMD_BlitRectAffine* cmd = (GPUCMD_BlitRectAffine*)header;
+    if(fb->colorDepth != EColorDepth_BGR565)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported affine blit target");
+        return;
+    }
 
-                        pixels[ index ] =  c;
-                        if(fb->attr)
-                            fb->attr[index] = cmd->writeAlpha;
-                    }
-                }
-            }   
-        } 
-        else if(buffer->textureFormat == ETextureFormat_8BPP)
-        {
-            uint8_t* srcBuffer = (uint8_t*)buffer->basePtr;
+    if(cmd->bufferId >= GPU_MAX_BUFFER_ID)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
 
-            // Get palette
-            struct GpuBufferInfo* palBuffer = gpu_get_buffer_by_id(gpu, cmd->palBufferId);
-            if(!palBuffer)
-            {
-                gpu_error(gpu, job, EGpuErrorCode_General, ""); 
-                return;
-            }
+    struct GpuBufferInfo* buffer = gpu_get_buffer_by_id(gpu, cmd->bufferId);
+    if(!buffer)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
 
-            // Ensure valid palette format
-            if(palBuffer->textureFormat != ETextureFormat_RGB16)
-            {
-                gpu_error(gpu, job, EGpuErrorCode_General, ""); 
-                return;
-            }
+    // src rect checked once, spans never leave it
+    uint32_t texelSz = buffer->textureFormat == ETextureFormat_RGB16 ? sizeof(uint16_t) : sizeof(uint8_t);
+    if(!cmd->srcW || !cmd->srcH || cmd->srcX + cmd->srcW > buffer->w 
+        || ((cmd->srcY + cmd->srcH - 1) * buffer->w + cmd->srcX + cmd->srcW) * texelSz > buffer->size)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Affine blit src out of bounds");
+        return;
+    }
 
-            for(int y=0;y<cmd->h;y++)
-            {
-                int localY = (cmd->dstY + y) - fb->y + cmd->srcY;
-                if(localY < 0 || localY >= fb->h)
-                    continue;
+    // blend mode -> span op
+    const uint16_t* pal = 0;
+    bool isRGB16 = buffer->textureFormat == ETextureFormat_RGB16;
+    int op = blit_affine_resolve_op(cmd->blendMode, buffer->textureFormat);
+    if(op < 0)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported affine blit blend mode for texture format");
+        return;
+    }
 
-                for(int x=0;x<cmd->w;x++)
-                {                    
-                    int localX = cmd->dstX + x;
-                    if(localX < 0 || localX >= fb->w)
-                        continue;
-                    
-                    int index = localX + (localY*fb->w);
-            
-                    uint8_t cid = srcBuffer[x + cmd->srcX  + ((y+ cmd->srcY)*buffer->w)];
-                    if(cid != cmd->colKey)
-                    {
-                        uint16_t c = ((uint16_t*)palBuffer->basePtr)[cid];                
-                        pixels[ index ] = c;
-                        if(fb->attr)
-                            fb->attr[index] = 0xff;       
-                    }
-                }
-            }
-        }
-        break;
-    }    
-    case EBlendMode_FillMasked:
+    if(op == EBlitSpanOp_Pal8 || op == EBlitSpanOp_Key8)
     {
-        if(buffer->textureFormat == ETextureFormat_RGB16)
-        {
-            uint16_t* srcBuffer = (uint16_t*)buffer->basePtr;
+        struct GPUCMD_BlitRect palCmd = {.palBufferId = cmd->palBufferId};
+        pal = blit_get_palette(gpu, job, &palCmd);
+        if(!pal)
+            return;
+    }
 
-            for(int y=pixelStartY;y<pixelCntY;y++)
-            {
-                // calc start pixel Y
-                int localY = pixelBaseY + y;
-                if(localY >= fb->h)
-                    break;
-                int pixelRowStride = (localY * fb->w);
-                int pixelCntX = cmd->w;
-                int baseRowOffset = ( ( y + cmd->srcY ) * buffer->w );
+    // clip dst bounds to tile
+    int pixelBaseX = cmd->dstX;
+    int pixelBaseY = cmd->dstY - fb->y;
+    int xBegin = pixelBaseX < 0 ? -pixelBaseX : 0;
+    int xEnd = MIN((int)cmd->dstW, (int)fb->w - pixelBaseX);
+    int yBegin = pixelBaseY < 0 ? -pixelBaseY : 0;
+    int yEnd = MIN((int)cmd->dstH, (int)fb->h - pixelBaseY);
+    if(xBegin >= xEnd)
+        return;
 
-                for(int x=pixelStartX;x<pixelCntX;x++)
-                {                    
-                    int localX = pixelBaseX + x;
-                    if(localX >= fb->w)
-                        break;
+    int32_t m[6];
+    memcpy(m, cmd->xform, sizeof(m));
+    int64_t limitU = (int64_t)cmd->srcW << 16;
+    int64_t limitV = (int64_t)cmd->srcH << 16;
+    uint16_t* pixels = (uint16_t*)fb->pixelsData;
+    uint32_t srcBase = cmd->srcX + (cmd->srcY * buffer->w);
 
-                    int index = localX + pixelRowStride;
+    for(int y=yBegin;y<yEnd;y++)
+    {
+        // row edges, span where u & v both inside src rect
+        int64_t u0 = ((int64_t)m[1] * y) + m[2];
+        int64_t v0 = ((int64_t)m[4] * y) + m[5];
+        int x0 = xBegin;
+        int x1 = xEnd;
+        blit_affine_clip(u0, m[0], limitU, &x0, &x1);
+        blit_affine_clip(v0, m[3], limitV, &x0, &x1);
+        if(x0 >= x1)
+            continue;
 
-                    uint32_t srcIndexX = x + cmd->srcX;
+        uint32_t u = (uint32_t)(u0 + ((int64_t)m[0] * x0));
+        uint32_t v = (uint32_t)(v0 + ((int64_t)m[3] * x0));
+        int index = ((pixelBaseY + y) * fb->w) + pixelBaseX + x0;
+        uint8_t* attr = fb->attr ? fb->attr + index : 0;
 
-                    if(cmd->flags & EDrawTextureFlags_FlippedX)
-                        srcIndexX = buffer->w - srcIndexX - 1;
-                        
-                    if( srcIndexX >= buffer->size)
-                        continue;
+        if(isRGB16)
+            blit_affine_span16(pixels + index, attr, (const uint16_t*)buffer->basePtr + srcBase, buffer->w, u, v, m[0], m[3], x1 - x0, op, cmd);
+        else
+            blit_affine_span8(pixels + index, attr, buffer->basePtr + srcBase, buffer->w, u, v, m[0], m[3], x1 - x0, op, pal, cmd);
+    }
+}
 
-                    uint16_t c = srcBuffer[ srcIndexX + baseRowOffset ];
 
-                    if(c != cmd->colKey)
-                    {
-                        pixels[ index ] = cmd->palBufferId; // fill masked
-                        if(fb->attr)
-                            fb->attr[index] = cmd->writeAlpha;
-                    }
-                }
-            }   
-        } 
-        else if(buffer->textureFormat == ETextureFormat_8BPP)
-        {
-            uint8_t* srcBuffer = (uint8_t*)buffer->basePtr;
+bool validate_gpu_cmd_impl_BlitRectAffine(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
+{
+    struct GPUCMD_BlitRectAffine* cmd = (GPUCMD_BlitRectAffine*)header;
 
-            for(int y=0;y<cmd->h;y++)
-            {
-                int localY = (cmd->dstY + y) - fb->y + cmd->srcY;
-                if(localY < 0 || localY >= fb->h)
-                    continue;
+    GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_BlitRectAffine));            
+    GPU_VALIDATE_ASSERT(cmd->bufferId < GPU_MAX_BUFFER_ID);
+        
+    info->extraArg0 = cmd->bufferId;
+    GPU_VALIDATE_ASSERT(cmd->srcW < 1024);
+    GPU_VALIDATE_ASSERT(cmd->srcH < 1024);
+    GPU_VALIDATE_ASSERT(cmd->dstW < 1024);
+    GPU_VALIDATE_ASSERT(cmd->dstH < 1024);
+    GPU_VALIDATE_ASSERT(blit_affine_resolve_op(cmd->blendMode, ETextureFormat_RGB16) >= 0);    // RGB16 supports every mode
+    if(info->checkBufferState)
+    {
+        const struct GpuBufferInfo* buffer = gpu_get_buffer_by_id((struct GpuState_t*)gpu, cmd->bufferId);
+        GPU_VALIDATE_ASSERT(buffer && blit_affine_resolve_op(cmd->blendMode, buffer->textureFormat) >= 0);
+    }
+        
+    return true;
+}
 
-                for(int x=0;x<cmd->w;x++)
-                {                    
-                    int localX = cmd->dstX + x;
-                    if(localX < 0 || localX >= fb->w)
-                        continue;
-                    
-                    int index = localX + (localY*fb->w);
-            
-                    uint8_t cid = srcBuffer[x + cmd->srcX  + ((y+ cmd->srcY)*buffer->w)];
-                    if(cid != cmd->colKey)
-                    {
-                        uint16_t c = cmd->palBufferId; // use as col
-                        pixels[ index ] = c;
-                        if(fb->attr)
-                            fb->attr[index] = 0xff;       
-                    }
+
+bool toString_gpu_cmd_impl_BlitRectAffine(const struct GpuState_t* gpu, struct GpuCmd_Header* header, char* buff, uint32_t buffSz)
+{
+    struct GPUCMD_BlitRectAffine* cmd = (GPUCMD_BlitRectAffine*)header;
+    int32_t m[6];
+    memcpy(m, cmd->xform, sizeof(m));
+    sprintf(buff, "bufferId:%d, srcX:%d, srcY:%d, srcW:%d, srcH:%d, dstX:%d, dstY:%d, dstW:%d, dstH:%d, blendMode:%d, xform:[%d %d %d, %d %d %d]", 
+            cmd->bufferId,
+            cmd->srcX,
+            cmd->srcY,    
+            cmd->srcW,
+            cmd->srcH,    
+            cmd->dstX,
+            cmd->dstY,
+            cmd->dstW,
+            cmd->dstH,      
+            cmd->blendMode,
+            m[0], m[1], m[2], m[3], m[4], m[5]);   
+    return true;
+}
+
+//
+// Tile grid blitter
+// Only map cells overlapping the tile frame are visited, each cell is clipped once and its rows 
+// go straight to the span kernels.
+
+/** Blit one clipped atlas tile, rows [y0,y1) & cols [x0,x1) are dst frame coords */
+static inline void blit_tile_cell(const struct GPUCMD_BlitTile* cmd, const struct GpuBufferInfo* atlas, const uint16_t* pal, TileFrameBuffer_t* fb, 
+    uint32_t srcIndex, int x0, int x1, int y0, int y1)
+{
+    uint32_t n = x1 - x0;
+    for(int y=y0;y<y1;y++, srcIndex += atlas->w)
+    {
+        int index = (y * fb->w) + x0;
+        uint8_t* attr = fb->attr ? fb->attr + index : 0;
+
+        if(fb->colorDepth == EColorDepth_8BPP)
+        {
+            uint8_t* dst = fb->pixelsData + index;
+            const uint8_t* src = atlas->basePtr + srcIndex;
+            if(cmd->blendMode == EBlendMode_None)
+                memcpy(dst, src, n);
+            else
+            {
+                for(uint32_t i=0;i<n;i++)
+                {
+                    if(src[i] != cmd->colKey)
+                        dst[i] = src[i];
                 }
             }
+            continue;
+        }
+
+        uint16_t* dst = (uint16_t*)fb->pixelsData + index;
+        if(atlas->textureFormat == ETextureFormat_RGB16)
+        {
+            const uint16_t* src = (const uint16_t*)atlas->basePtr + srcIndex;
+            if(cmd->blendMode == EBlendMode_None)
+            {
+                blit_span_copy16(dst, src, 1, n);
+                if(attr)
+                    memset(attr, GPU_ATTR_ALPHA_MASK, n);
+            }
+            else
+                blit_span_key16(dst, attr, src, 1, n, EBlitSpanOp_Key16, cmd->colKey, 0, GPU_ATTR_ALPHA_MASK);
+        }
+        else
+        {
+            const uint8_t* src = atlas->basePtr + srcIndex;
+            if(cmd->blendMode == EBlendMode_None)
+            {
+                blit_span_pal8(dst, src, 1, pal, n);
+                if(attr)
+                    memset(attr, GPU_ATTR_ALPHA_MASK, n);
+            }
+            else
+                blit_span_key8(dst, attr, src, n, cmd->colKey, pal, 0);
         }
-        break;        
     }
-    case EBlendMode_ColkeyAlpha:
+}
+
+
+/** BlitTilemapData in buffer, 0 when header or mapW*mapH tiles don't fit ( 64-bit count, size_t is 32-bit on device ) */
+static const BlitTilemapData* blit_tilemap_data_get(const struct GpuBufferInfo* tileData)
+{
+    if(!tileData || !tileData->basePtr || tileData->size < sizeof(BlitTilemapData))
+        return 0;
+
+    const BlitTilemapData* map = (const BlitTilemapData*)tileData->basePtr;
+    if((uint64_t)map->mapW * map->mapH > (tileData->size - sizeof(BlitTilemapData)) / sizeof(uint16_t))
+        return 0;
+    return map;
+}
+
+
+void gpu_cmd_impl_BlitTile(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    struct GPUCMD_BlitTile* cmd = (GPUCMD_BlitTile*)header;
+    struct GpuBufferInfo* atlas = gpu_get_buffer_by_id(gpu, cmd->textureBufferId);
+    struct GpuBufferInfo* tileData = gpu_get_buffer_by_id(gpu, cmd->tileDataBufferId);
+    if(!atlas || !tileData)
     {
-        if(buffer->textureFormat == ETextureFormat_RGB16)
-        {
-            uint16_t* srcBuffer = (uint16_t*)buffer->basePtr;
+        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        return;
+    }
 
-            for(int y=pixelStartY;y<pixelCntY;y++)
-            {
-                // calc start pixel Y
-                int localY = pixelBaseY + y;
-                if(localY >= fb->h)
-                    break;
-                int pixelRowStride = (localY * fb->w);
-                int pixelCntX = cmd->w;
-                int baseRowOffset = ( ( y + cmd->srcY ) * buffer->w );
+    const BlitTilemapData* map = blit_tilemap_data_get(tileData);
+    if(!map)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Invalid tilemap data");
+        return;
+    }
 
-                for(int x=pixelStartX;x<pixelCntX;x++)
-                {                    
-                    int localX = pixelBaseX + x;
-                    if(localX >= fb->w)
-                        break;
+    uint32_t tileW = map->tileW;
+    uint32_t tileH = map->tileH;
+    uint32_t mapW = map->mapW;
+    uint32_t mapH = map->mapH;
+    if(!tileW || !tileH || tileW > atlas->w)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Invalid tilemap data");
+        return;
+    }
 
-                    int index = localX + pixelRowStride;
+    // target & atlas formats
+    bool isRGB16 = atlas->textureFormat == ETextureFormat_RGB16;
+    bool is8bpp = atlas->textureFormat == ETextureFormat_8BPP;
+    if((cmd->blendMode != EBlendMode_None && cmd->blendMode != EBlendMode_ColorKey) 
+        || (!isRGB16 && !is8bpp) 
+        || (fb->colorDepth == EColorDepth_8BPP && !is8bpp))
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit tile mode");
+        return;
+    }
 
-                    uint32_t srcIndexX = x + cmd->srcX;
+    const uint16_t* pal = 0;
+    if(is8bpp && fb->colorDepth == EColorDepth_BGR565)
+    {
+        struct GPUCMD_BlitRect palCmd = {.palBufferId = cmd->palBufferId};
+        pal = blit_get_palette(gpu, job, &palCmd);
+        if(!pal)
+            return;
+    }
 
-                    if(cmd->flags & EDrawTextureFlags_FlippedX)
-                        srcIndexX = buffer->w - srcIndexX - 1;
-                        
-                    if( srcIndexX >= buffer->size)
-                        continue;
+    // atlas tiles inside buffer
+    uint32_t texelSz = isRGB16 ? sizeof(uint16_t) : sizeof(uint8_t);
+    uint32_t atlasCols = atlas->w / tileW;
+    uint32_t atlasTileCnt = atlasCols * ((atlas->size / texelSz) / (atlas->w * tileH));
+
+    // grid clip in frame coords, frame rows relative to fb->y
+    int clipX0 = MAX(0, (int)cmd->dstX);
+    int clipX1 = MIN((int)fb->w, (int)cmd->dstX + (int)MIN((uint32_t)cmd->w, mapW * tileW));
+    int clipY0 = MAX((int)fb->y, (int)cmd->dstY);
+    int clipY1 = MIN((int)fb->y + (int)fb->h, (int)cmd->dstY + (int)MIN((uint32_t)cmd->h, mapH * tileH));
+    if(clipX0 >= clipX1 || clipY0 >= clipY1)
+        return;
 
-                    uint16_t col = srcBuffer[ srcIndexX + baseRowOffset ];  
-                    if(col)
-                    {
-                        pixels[index] = ALPHA_BLIT16_565(col, pixels[index], cmd->colKey);                           
-                        if(fb->attr)
-                            fb->attr[index] = cmd->colKey;                      
-                    }
-                }
-            }   
-        } 
-        break;
-    }  
-    case EBlendMode_Add:
+    // visible cell range
+    int cellX0 = (clipX0 - cmd->dstX) / (int)tileW;
+    int cellX1 = ((clipX1 - cmd->dstX) + (int)tileW - 1) / (int)tileW;
+    int cellY0 = (clipY0 - cmd->dstY) / (int)tileH;
+    int cellY1 = ((clipY1 - cmd->dstY) + (int)tileH - 1) / (int)tileH;
+
+    for(int cy=cellY0;cy<cellY1;cy++)
     {
-        if(buffer->textureFormat == ETextureFormat_RGB16)
+        int tileY = cmd->dstY + (cy * (int)tileH);
+        int y0 = MAX(tileY, clipY0);
+        int y1 = MIN(tileY + (int)tileH, clipY1);
+        const uint16_t* row = map->tiles + (cy * mapW);
+
+        for(int cx=cellX0;cx<cellX1;cx++)
         {
-            uint16_t* srcBuffer = (uint16_t*)buffer->basePtr;
+            uint16_t tileId = row[cx];
+            if(tileId == BLIT_TILE_EMPTY || tileId >= atlasTileCnt)
+                continue;
 
-            for(int y=pixelStartY;y<pixelCntY;y++)
-            {
-                // calc start pixel Y
-                int localY = pixelBaseY + y;
-                if(localY >= fb->h)
-                    break;
+            int tileX = cmd->dstX + (cx * (int)tileW);
+            int x0 = MAX(tileX, clipX0);
+            int x1 = MIN(tileX + (int)tileW, clipX1);
 
-                int fillY = y;
-                if(fillY >= buffer->h )
-                    fillY = fillY % buffer->h;
-                    
-                int pixelRowStride = (localY * fb->w);
-                int pixelCntX = cmd->w;
-                int baseRowOffset = ( ( fillY + cmd->srcY ) * buffer->w );
+            uint32_t srcX = ((tileId % atlasCols) * tileW) + (x0 - tileX);
+            uint32_t srcY = ((tileId / atlasCols) * tileH) + (y0 - tileY);
+            blit_tile_cell(cmd, atlas, pal, fb, srcX + (srcY * atlas->w), x0, x1, y0 - fb->y, y1 - fb->y);
+        }
+    }
+}
 
-                for(int x=pixelStartX;x<pixelCntX;x++)
-                {                    
-                    int localX = pixelBaseX + x;
-                    if(localX >= fb->w)
-                        break;
 
-                    int index = localX + pixelRowStride;
+bool validate_gpu_cmd_impl_BlitTile(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
+{
+    struct GPUCMD_BlitTile* cmd = (GPUCMD_BlitTile*)header;
+
+    GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_BlitTile));            
+    GPU_VALIDATE_ASSERT(cmd->textureBufferId < GPU_MAX_BUFFER_ID);
+    GPU_VALIDATE_ASSERT(cmd->tileDataBufferId < GPU_MAX_BUFFER_ID);
+        
+    info->extraArg0 = cmd->textureBufferId;
+    return true;
+}
 
-                    uint32_t srcIndexX = x + cmd->srcX;
-                    if(srcIndexX > buffer->w)
-                        srcIndexX = srcIndexX % buffer->w;
 
-                    if(cmd->flags & EDrawTextureFlags_FlippedX)
-                        srcIndexX = buffer->w - srcIndexX - 1;
-                        
-                    if( srcIndexX >= buffer->size)
-                        continue;
+bool toString_gpu_cmd_impl_BlitTile(const struct GpuState_t* gpu, struct GpuCmd_Header* header, char* buff, uint32_t buffSz)
+{
+    struct GPUCMD_BlitTile* cmd = (GPUCMD_BlitTile*)header;
+    sprintf(buff, "textureBufferId:%d, tileDataBufferId:%d, dstX:%d, dstY:%d, w:%d, h:%d, colKey:%d, palBid:%d, blendMode:%d", 
+            cmd->textureBufferId,
+            cmd->tileDataBufferId,
+            cmd->dstX,
+            cmd->dstY,
+            cmd->w,
+            cmd->h,      
+            cmd->colKey,
+            cmd->palBufferId,
+            cmd->blendMode);   
+    return true;
+}
+
+
+//
+// Scroll layer
+// Wrapping tilemap background, map row is fixed per frame row so each visible cell on the row is one span 
+// into blit_tile_cell. Line scroll offsets only move the row start.
 
-                    uint16_t c = srcBuffer[ srcIndexX + baseRowOffset ];
-                    c = gpu_col_add_uint16(pixels[ index ], c );   
-                    
-                    pixels[ index ] = c;
-                    if(fb->attr)
-                        fb->attr[index] = cmd->writeAlpha;
-                }
-            }   
-            break;
-        }                 
-    }            
-    default:
-        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit blend mode");
-        return;            
-    }
+static inline int scroll_layer_wrap(int v, int sz)
+{
+    v %= sz;
+    return v < 0 ? v + sz : v;
 }
 
 
-void gpu_cmd_impl_BlitRect8bpp(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+void gpu_cmd_impl_DrawScrollLayer(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
 {
-    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
-    uint8_t* pixels = (uint8_t*)fb->pixelsData;
-    if(cmd->bufferId >= GPU_MAX_BUFFER_ID)
+    struct GPUCMD_DrawScrollLayer* cmd = (GPUCMD_DrawScrollLayer*)header;
+    struct GpuBufferInfo* atlas = gpu_get_buffer_by_id(gpu, cmd->textureBufferId);
+    struct GpuBufferInfo* tileData = gpu_get_buffer_by_id(gpu, cmd->tileDataBufferId);
+    if(!atlas || !tileData)
     {
         gpu_error(gpu, job, EGpuErrorCode_General, "");
         return;
     }
 
-    struct GpuBufferInfo* buffer = gpu_get_buffer_by_id(gpu, cmd->bufferId);
-    if(!buffer)
+    const BlitTilemapData* map = blit_tilemap_data_get(tileData);
+    if(!map)
     {
-        gpu_error(gpu, job, EGpuErrorCode_General, "");
+        gpu_error(gpu, job, EGpuErrorCode_General, "Invalid tilemap data");
         return;
     }
 
-    int pixelBaseX = cmd->dstX;
-    int pixelBaseY = cmd->dstY - fb->y;
-    int pixelStartY = 0;   
-    if(pixelBaseY < 0)
-        pixelStartY = -pixelBaseY;
-
-    // calc start pixel X ()
-    int pixelStartX = 0;   
-    if(pixelBaseX < 0)
-        pixelStartX = -pixelBaseX;
-    int pixelCntY = cmd->h;
+    uint32_t tileW = map->tileW;
+    uint32_t tileH = map->tileH;
+    uint32_t mapW = map->mapW;
+    uint32_t mapH = map->mapH;
+    if(!tileW || !tileH || !mapW || !mapH || tileW > atlas->w)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Invalid tilemap data");
+        return;
+    }
 
-    switch (cmd->blendMode)
+    // target & atlas formats
+    bool isRGB16 = atlas->textureFormat == ETextureFormat_RGB16;
+    bool is8bpp = atlas->textureFormat == ETextureFormat_8BPP;
+    if((cmd->blendMode != EBlendMode_None && cmd->blendMode != EBlendMode_ColorKey) 
+        || (!isRGB16 && !is8bpp) 
+        || (fb->colorDepth == EColorDepth_8BPP && !is8bpp))
     {
-    case EBlendMode_None:
+        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported scroll layer mode");
+        return;
+    }
+
+    const uint16_t* pal = 0;
+    if(is8bpp && fb->colorDepth == EColorDepth_BGR565)
     {
-        if(buffer->textureFormat == ETextureFormat_8BPP)
-        {
-            uint8_t* srcBuffer = (uint8_t*)buffer->basePtr;
+        struct GPUCMD_BlitRect palCmd = {.palBufferId = cmd->palBufferId};
+        pal = blit_get_palette(gpu, job, &palCmd);
+        if(!pal)
+            return;
+    }
 
-            for(int y=0;y<cmd->h;y++)
-            {
-                int localY = (cmd->dstY + y) - fb->y + cmd->srcY;
-                if(localY < 0 || localY >= fb->h)
-                    continue;
+    // layer rows in frame coords
+    int clipY0 = MAX((int)fb->y, (int)cmd->y);
+    int clipY1 = MIN((int)fb->y + (int)fb->h, (int)cmd->y + (int)cmd->h);
+    if(clipY0 >= clipY1)
+        return;
 
-                for(int x=0;x<cmd->w;x++)
-                {                    
-                    int localX = cmd->dstX + x;
-                    if(localX < 0 || localX >= fb->w)
-                        continue;
-                    
-                    int index = localX + (localY*fb->w);
-            
-                    uint8_t cid = srcBuffer[x + cmd->srcX  + ((y+ cmd->srcY)*buffer->w)];
-                    pixels[ index ] = cid;
-                }
-            }
+    // line table indexed by screen row
+    const int16_t* lineScroll = 0;
+    if(cmd->lineScrollBufferId != SCROLL_LAYER_NO_LINE_SCROLL)
+    {
+        struct GpuBufferInfo* lineBuffer = gpu_get_buffer_by_id(gpu, cmd->lineScrollBufferId);
+        if(!lineBuffer || lineBuffer->size < clipY1 * sizeof(int16_t))
+        {
+            gpu_error(gpu, job, EGpuErrorCode_General, "Invalid line scroll buffer");
+            return;
         }
-        break;
-    }                
-    default:
-        gpu_error(gpu, job, EGpuErrorCode_General, "Unsupported blit blend mode");
-        return;            
+        lineScroll = (const int16_t*)lineBuffer->basePtr;
     }
-}
 
+    // atlas tiles inside buffer
+    uint32_t texelSz = isRGB16 ? sizeof(uint16_t) : sizeof(uint8_t);
+    uint32_t atlasCols = atlas->w / tileW;
+    uint32_t atlasTileCnt = atlasCols * ((atlas->size / texelSz) / (atlas->w * tileH));
 
-void gpu_cmd_impl_BlitRect(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
-{
-    if(fb->colorDepth == EColorDepth_BGR565)
-    {
-        gpu_cmd_impl_BlitRect16bpp( gpu, job, header, fb);
-    }
-    else if(fb->colorDepth == EColorDepth_8BPP)
+    struct GPUCMD_BlitTile cellCmd = {.colKey = cmd->colKey, .blendMode = cmd->blendMode};
+    int mapPxW = mapW * tileW;
+    int mapPxH = mapH * tileH;
+    int mapY = scroll_layer_wrap(cmd->scrollY + clipY0, mapPxH);
+    for(int y=clipY0;y<clipY1;y++)
     {
-        gpu_cmd_impl_BlitRect8bpp( gpu, job, header, fb);
-    }
+        uint32_t cy = mapY / tileH;
+        uint32_t ty = mapY - (cy * tileH);
+        const uint16_t* row = map->tiles + (cy * mapW);
+
+        int mapX = scroll_layer_wrap(cmd->scrollX + (lineScroll ? lineScroll[y] : 0), mapPxW);
+        uint32_t cx = mapX / tileW;
+        uint32_t tx = mapX - (cx * tileW);
+        for(int x=0;x<fb->w;)
+        {
+            int n = MIN((int)(tileW - tx), (int)fb->w - x);
+            uint16_t tileId = row[cx];
+            if(tileId != BLIT_TILE_EMPTY && tileId < atlasTileCnt)
+            {
+                uint32_t srcX = ((tileId % atlasCols) * tileW) + tx;
+                uint32_t srcY = ((tileId / atlasCols) * tileH) + ty;
+                blit_tile_cell(&cellCmd, atlas, pal, fb, srcX + (srcY * atlas->w), x, x + n, y - fb->y, y - fb->y + 1);
+            }
+
+            x += n;
+            tx = 0;
+            if(++cx == mapW)
+                cx = 0;
+        }
 
+        if(++mapY == mapPxH)
+            mapY = 0;
+    }
 }
 
 
-bool validate_gpu_cmd_impl_BlitRect(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
+bool validate_gpu_cmd_impl_DrawScrollLayer(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
 {
-    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
+    struct GPUCMD_DrawScrollLayer* cmd = (GPUCMD_DrawScrollLayer*)header;
 
-    GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_BlitRect));            
-    GPU_VALIDATE_ASSERT(cmd->bufferId < GPU_MAX_BUFFER_ID);
-        
-    info->extraArg0 = cmd->bufferId;
-    //GPU_VALIDATE_ASSERT(info->buffersCreated[cmd->bufferId]);    // NOTE: buffers are global state
-    GPU_VALIDATE_ASSERT(cmd->w < 1024);
-    GPU_VALIDATE_ASSERT(cmd->h < 1024);
+    GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_DrawScrollLayer));            
+    GPU_VALIDATE_ASSERT(cmd->textureBufferId < GPU_MAX_BUFFER_ID);
+    GPU_VALIDATE_ASSERT(cmd->tileDataBufferId < GPU_MAX_BUFFER_ID);
+    GPU_VALIDATE_ASSERT(cmd->lineScrollBufferId == SCROLL_LAYER_NO_LINE_SCROLL || cmd->lineScrollBufferId < GPU_MAX_BUFFER_ID);
         
+    info->extraArg0 = cmd->textureBufferId;
     return true;
 }
 
 
-bool toString_gpu_cmd_impl_BlitRect(const struct GpuState_t* gpu, struct GpuCmd_Header* header, char* buff, uint32_t buffSz)
+bool toString_gpu_cmd_impl_DrawScrollLayer(const struct GpuState_t* gpu, struct GpuCmd_Header* header, char* buff, uint32_t buffSz)
 {
-    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
-    sprintf(buff, "bufferId:%d, srcX:%d, srcY:%d, dstX:%d, dstY:%d, w:%d, h:%d, colKey:%d, palBid:%d", 
-            cmd->bufferId,
-            cmd->srcX,
-            cmd->srcY,    
-            cmd->dstX,
-            cmd->dstY,
-            cmd->w,
+    struct GPUCMD_DrawScrollLayer* cmd = (GPUCMD_DrawScrollLayer*)header;
+    sprintf(buff, "textureBufferId:%d, tileDataBufferId:%d, lineScrollBid:%d, scrollX:%d, scrollY:%d, y:%d, h:%d, colKey:%d, palBid:%d, blendMode:%d", 
+            cmd->textureBufferId,
+            cmd->tileDataBufferId,
+            cmd->lineScrollBufferId,
+            cmd->scrollX,
+            cmd->scrollY,
+            cmd->y,
             cmd->h,      
             cmd->colKey,
-            cmd->palBufferId);   
+            cmd->palBufferId,
+            cmd->blendMode);   
     return true;
 }
 
 
+
 void gpu_cmd_impl_RegisterCmd(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* tile)
 {
     GPUCMD_RegisterCmd* cmd = (GPUCMD_RegisterCmd*)header;
+    gpu->bufferWriteCnt++;
     
     if(gpu_register_cmd_jit(gpu, cmd->cmdId, cmd->bufferId) != SDKErr_OK)
     {
@@ -1291,6 +2320,385 @@ uint8_t getTileFluid(struct GpuBufferInfo* tilemapDataBuffer, struct GpuBufferIn
 }
 
 
+// Resolve autotile variant from the 8 neighbours sharing tileGroup, returns tileLookup id in 8x8 tile sheet
+static uint8_t tilemap_resolve_autotile(struct GpuBufferInfo* tilemapDataBuffer, int tileX, int tileY, struct GPUAttr_DrawTileMapData* tileInfos, uint8_t layerId, uint32_t tileInfosCnt, uint8_t tileIdMask, uint32_t tileGroup)
+{
+    // sample tile (accross edges/chunks)
+    uint32_t northWestVal = getTileGroup(tilemapDataBuffer, tileX - 1, tileY - 1, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+    uint32_t northVal = getTileGroup(tilemapDataBuffer, tileX, tileY - 1, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+    uint32_t northEastVal = getTileGroup(tilemapDataBuffer, tileX + 1, tileY - 1, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+    uint32_t westVal = getTileGroup(tilemapDataBuffer, tileX - 1, tileY, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+    uint32_t eastVal = getTileGroup(tilemapDataBuffer, tileX + 1, tileY, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+    uint32_t southWestVal = getTileGroup(tilemapDataBuffer, tileX - 1, tileY + 1, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+    uint32_t southVal = getTileGroup(tilemapDataBuffer, tileX, tileY + 1, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+    uint32_t southEastVal = getTileGroup(tilemapDataBuffer, tileX + 1, tileY + 1, tileInfos, layerId, tileInfosCnt, tileIdMask) == tileGroup;
+
+    if (northVal == 0 || westVal == 0)
+        northWestVal = 0;
+
+    if (northVal == 0 || eastVal == 0)
+        northEastVal = 0;
+
+    if (southVal == 0 || westVal == 0)
+        southWestVal = 0;
+
+    if (southVal == 0 || eastVal == 0)
+        southEastVal = 0;
+
+    uint32_t autoTileId = (northWestVal * 1) + (northVal * 2) + (northEastVal * 4) + (westVal * 8) + (eastVal * 16) + (southWestVal * 32) + (southVal * 64) + (southEastVal * 128);
+    return tileLookup[autoTileId];
+}
+
+
+// Seeded anim phase source, frame offset is this % tileFrameCnt
+static inline uint32_t tilemap_phase_rng(uint32_t seed, int tileX, int tileY)
+{
+    struct pseudo_random_t rng;
+    pseudo_random_init(&rng); 
+    pseudo_random_offset_seed(&rng, seed, seed); 
+    pseudo_random_offset_seed(&rng, tileX, tileY); 
+    return pseudo_random_uint(&rng);
+}
+
+
+// Anim frame offset for cell, cached phase when frame cnt divides its modulus
+static inline uint32_t tilemap_frame_offset(const uint16_t* phases, uint32_t seed, int tileX, int tileY, uint8_t tileFrameCnt)
+{
+    if(phases && tileFrameCnt && (GPU_TILE_PHASE_MOD % tileFrameCnt) == 0)
+        return phases[tileX + (tileY * GPU_TILEMAP_TILE_SZ)] % tileFrameCnt;
+    return tilemap_phase_rng(seed, tileX, tileY) % tileFrameCnt;
+}
+
+
+// Build phase table for seed before tiles run, least recently prepared seed evicted
+static void tilemap_phases_prepare(struct GpuTilemapCaches_t* caches, uint32_t seed)
+{
+    GpuTilemapPhases_t* entry = 0;
+    GpuTilemapPhases_t* oldest = &caches->tilemapPhases[0];
+    for(int i=0;i<GPU_TILE_PHASE_CNT;i++)
+    {
+        GpuTilemapPhases_t* it = &caches->tilemapPhases[i];
+        if(it->isValid && it->seed == seed)
+        {
+            entry = it;
+            break;
+        }
+        if(it->lastPrepareId < oldest->lastPrepareId)
+            oldest = it;
+    }
+
+    if(!entry)
+    {
+        entry = oldest;
+        for(int y=0;y<GPU_TILEMAP_TILE_SZ;y++)
+        {
+            for(int x=0;x<GPU_TILEMAP_TILE_SZ;x++)
+                entry->phases[x + (y * GPU_TILEMAP_TILE_SZ)] = tilemap_phase_rng(seed, x, y) % GPU_TILE_PHASE_MOD;
+        }
+        entry->seed = seed;
+        entry->isValid = true;
+    }
+    entry->lastPrepareId = caches->prepareCnt;
+}
+
+
+// Find phase table for seed, 0 uses rng per tile
+static const uint16_t* tilemap_phases_find(struct GpuState_t* gpu, uint32_t seed)
+{
+    if(!gpu->tilemapCaches)
+        return 0;
+    for(int i=0;i<GPU_TILE_PHASE_CNT;i++)
+    {
+        const GpuTilemapPhases_t* entry = &gpu->tilemapCaches->tilemapPhases[i];
+        if(entry->isValid && entry->seed == seed)
+            return entry->phases;
+    }
+    return 0;
+}
+
+
+// Scan sheet at frame offset for tiles with no transparent pixels, skipped when cached at the texture's writeCnt
+static void tilemap_opaque_sheet_prepare(struct GpuTilemapCaches_t* caches, struct GpuBufferInfo* texture, struct GPUAttr_TileFrame* frame)
+{
+    GpuTileOpaqueSheet_t* entry = 0;
+    GpuTileOpaqueSheet_t* oldest = &caches->opaqueSheets[0];
+    for(int i=0;i<GPU_TILE_OPAQUE_SHEET_CNT;i++)
+    {
+        GpuTileOpaqueSheet_t* it = &caches->opaqueSheets[i];
+        if(it->texture == texture && it->x == frame->x && it->y == frame->y)
+        {
+            entry = it;
+            break;
+        }
+        if(it->lastPrepareId < oldest->lastPrepareId)
+            oldest = it;
+    }
+
+    if(!entry)
+    {
+        // all used by this prepare, sheet draws every layer
+        if(oldest->texture && oldest->lastPrepareId == caches->prepareCnt)
+            return;
+        entry = oldest;
+        entry->texture = texture;
+        entry->x = frame->x;
+        entry->y = frame->y;
+        entry->textureWriteCnt = texture->writeCnt + 1;
+    }
+    entry->lastPrepareId = caches->prepareCnt;
+
+    if(entry->textureWriteCnt == texture->writeCnt)
+        return;
+
+    uint64_t opaqueTiles = 0;
+    const uint16_t* pixels = (const uint16_t*)texture->basePtr;
+    if((uint32_t)texture->w * texture->h * sizeof(uint16_t) <= texture->size)
+    {
+        for(int tileId=0;tileId<64;tileId++)
+        {
+            int tileX = frame->x + ((tileId % 8) * GPU_TILEMAP_TILE_SZ);
+            int tileY = frame->y + ((tileId / 8) * GPU_TILEMAP_TILE_SZ);
+            if(tileX + GPU_TILEMAP_TILE_SZ > texture->w || tileY + GPU_TILEMAP_TILE_SZ > texture->h)
+                continue;
+
+            bool opaque = true;
+            for(int y=0;y<GPU_TILEMAP_TILE_SZ && opaque;y++)
+            {
+                const uint16_t* row = pixels + tileX + ((tileY + y) * texture->w);
+                for(int x=0;x<GPU_TILEMAP_TILE_SZ;x++)
+                {
+                    if(!row[x])
+                    {
+                        opaque = false;
+                        break;
+                    }
+                }
+            }
+
+            if(opaque)
+                opaqueTiles |= 1ull << tileId;
+        }
+    }
+    entry->opaqueTiles = opaqueTiles;
+    entry->textureWriteCnt = texture->writeCnt;
+}
+
+
+// Opaque sheets for every AutoTile/Decals layer frame the tile infos can draw
+static void tilemap_opaque_prepare(struct GpuState_t* gpu, struct GpuTilemapCaches_t* caches, struct GPUAttr_DrawTileMapData* tileInfos, uint32_t tileInfosCnt)
+{
+    for(uint32_t i=0;i<tileInfosCnt;i++)
+    {
+        struct GPUAttr_DrawTileMapData* tileInfo = &tileInfos[i];
+        if(!tileInfo->isValid)
+            continue;
+
+        int layerCnt = tileInfo->layerCnt < GPU_TILE_MAX_LAYERS ? tileInfo->layerCnt : GPU_TILE_MAX_LAYERS;
+        for(int layerId=0;layerId<layerCnt;layerId++)
+        {
+            struct GPUAttr_TileDataLayer* layer = &tileInfo->layers[layerId];
+            if(layer->type != EGPUAttr_ETileRenderType_AutoTile && layer->type != EGPUAttr_ETileRenderType_Decals)
+                continue;
+            if(layer->textureBufferId >= GPU_MAX_BUFFER_ID)
+                continue;
+
+            struct GpuBufferInfo* texture = &gpu->buffers[layer->textureBufferId];
+            if(!texture->isValid || !texture->basePtr)
+                continue;
+
+            int frameCnt = layer->tileFrameCnt < GPU_TILE_MAX_FRAMES ? layer->tileFrameCnt : GPU_TILE_MAX_FRAMES;
+            if(!frameCnt)
+                frameCnt = 1;
+            for(int frameId=0;frameId<frameCnt;frameId++)
+                tilemap_opaque_sheet_prepare(caches, texture, &layer->tileFrames[frameId]);
+        }
+    }
+}
+
+
+// Find opaque tiles of layer sheet at frame, 0 when not prepared or texture written since
+static uint64_t tilemap_opaque_find(struct GpuState_t* gpu, struct GPUAttr_TileDataLayer* layer, struct GPUAttr_TileFrame* frame)
+{
+    if(!gpu->tilemapCaches || layer->textureBufferId >= GPU_MAX_BUFFER_ID)
+        return 0;
+
+    struct GpuBufferInfo* texture = &gpu->buffers[layer->textureBufferId];
+    for(int i=0;i<GPU_TILE_OPAQUE_SHEET_CNT;i++)
+    {
+        const GpuTileOpaqueSheet_t* entry = &gpu->tilemapCaches->opaqueSheets[i];
+        if(entry->texture == texture && entry->x == frame->x && entry->y == frame->y)
+            return entry->textureWriteCnt == texture->writeCnt ? entry->opaqueTiles : 0;
+    }
+    return 0;
+}
+
+
+static inline struct GpuBufferInfo* tilemap_cache_edge(struct GpuBufferInfo* tilemapDataBuffer, int edgeId)
+{
+    return edgeId == 4 ? tilemapDataBuffer : tilemapDataBuffer->edgeData[edgeId];
+}
+
+
+// Find cache entry still valid for chunk, 0 resolves per tile
+static const GpuTilemapCache_t* tilemap_cache_find(struct GpuState_t* gpu, struct GpuBufferInfo* tilemapDataBuffer, struct GpuBufferInfo* tilemapAttribBuffer, uint8_t tileIdMask)
+{
+    if(!gpu->tilemapCaches)
+        return 0;
+    for(int i=0;i<GPU_TILEMAP_CACHE_CNT;i++)
+    {
+        const GpuTilemapCache_t* entry = &gpu->tilemapCaches->tilemapCache[i];
+        if(entry->tilemapDataBuffer != tilemapDataBuffer || entry->tilemapAttribBuffer != tilemapAttribBuffer || entry->tileIdMask != tileIdMask)
+            continue;
+
+        // written since prepare, eg. by this list
+        if(entry->attribWriteCnt != tilemapAttribBuffer->writeCnt)
+            return 0;
+        for(int j=0;j<9;j++)
+        {
+            struct GpuBufferInfo* edge = tilemap_cache_edge(tilemapDataBuffer, j);
+            if(edge != entry->edges[j] || (edge ? edge->writeCnt : 0) != entry->edgeWriteCnts[j])
+                return 0;
+        }
+        return entry;
+    }
+    return 0;
+}
+
+
+// Refresh chunk autotiles before tiles run, only cells with a changed neighbourhood are resolved again
+void gpu_cmd_impl_DrawTileMap_prepare(struct GpuState_t* gpu, struct GpuCmd_Header* header)
+{
+    GPUCMD_DrawTileMap* cmd = (GPUCMD_DrawTileMap*)header;
+    GpuTilemapCaches_t* caches = gpu->tilemapCaches;
+    if(!caches || header->sz != sizeof(GPUCMD_DrawTileMap))
+        return;
+
+    struct GpuBufferInfo* tilemapDataBuffer = gpu_get_buffer_by_id(gpu, cmd->tilemapDataBufferId);
+    if(!tilemapDataBuffer || !tilemapDataBuffer->basePtr || tilemapDataBuffer->size < GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ)
+        return;
+
+    struct GpuBufferInfo* tilemapAttribBuffer = gpu_get_buffer_by_id(gpu, cmd->tilemapAttribBufferId);
+    if(!tilemapAttribBuffer || !tilemapAttribBuffer->basePtr)
+        return;
+
+    struct GPUAttr_DrawTileMapData* tileInfos = (struct GPUAttr_DrawTileMapData*)tilemapAttribBuffer->basePtr;
+    uint32_t tileInfosCnt = tilemapAttribBuffer->size / sizeof(struct GPUAttr_DrawTileMapData);
+    uint8_t* tileData = tilemapDataBuffer->basePtr;
+
+    // find chunk or evict oldest
+    caches->prepareCnt++;
+    tilemap_phases_prepare(caches, cmd->seed);
+    tilemap_opaque_prepare(gpu, caches, tileInfos, tileInfosCnt);
+    GpuTilemapCache_t* entry = 0;
+    GpuTilemapCache_t* oldest = &caches->tilemapCache[0];
+    for(int i=0;i<GPU_TILEMAP_CACHE_CNT;i++)
+    {
+        GpuTilemapCache_t* it = &caches->tilemapCache[i];
+        if(it->tilemapDataBuffer == tilemapDataBuffer && it->tilemapAttribBuffer == tilemapAttribBuffer && it->tileIdMask == cmd->tileIdMask)
+        {
+            entry = it;
+            break;
+        }
+        if(it->lastPrepareId < oldest->lastPrepareId)
+            oldest = it;
+    }
+
+    bool resolveAll = false;
+    if(!entry)
+    {
+        entry = oldest;
+        entry->tilemapDataBuffer = tilemapDataBuffer;
+        entry->tilemapAttribBuffer = tilemapAttribBuffer;
+        entry->tileIdMask = cmd->tileIdMask;
+        resolveAll = true;
+    }
+    entry->lastPrepareId = caches->prepareCnt;
+
+    if(entry->attribWriteCnt != tilemapAttribBuffer->writeCnt)
+        resolveAll = true;
+    for(int i=0;i<9;i++)
+    {
+        if(entry->edges[i] != tilemap_cache_edge(tilemapDataBuffer, i))
+            resolveAll = true;
+    }
+
+    // dirty cells, bit per x
+    uint16_t dirtyRows[GPU_TILEMAP_TILE_SZ];
+    memset(dirtyRows, resolveAll ? 0xff : 0, sizeof(dirtyRows));
+    if(!resolveAll)
+    {
+        // edge chunk written, cells along that side
+        for(int i=0;i<9;i++)
+        {
+            struct GpuBufferInfo* edge = entry->edges[i];
+            if(i == 4 || !edge || edge->writeCnt == entry->edgeWriteCnts[i])
+                continue;
+
+            int relX = (i % 3) - 1;
+            int relY = (i / 3) - 1;
+            uint16_t colMask = relX < 0 ? 1 : (relX > 0 ? 1 << (GPU_TILEMAP_TILE_SZ-1) : 0xffff);
+            for(int y=0;y<GPU_TILEMAP_TILE_SZ;y++)
+            {
+                if(relY == 0 || (relY < 0 && y == 0) || (relY > 0 && y == GPU_TILEMAP_TILE_SZ-1))
+                    dirtyRows[y] |= colMask;
+            }
+        }
+
+        // chunk written, changed cells & neighbours
+        if(tilemapDataBuffer->writeCnt != entry->edgeWriteCnts[4])
+        {
+            for(int y=0;y<GPU_TILEMAP_TILE_SZ;y++)
+            {
+                for(int x=0;x<GPU_TILEMAP_TILE_SZ;x++)
+                {
+                    int index = x + (y * GPU_TILEMAP_TILE_SZ);
+                    if((tileData[index] & cmd->tileIdMask) == entry->tileIds[index])
+                        continue;
+
+                    uint16_t colMask = (0x7 << x) >> 1;
+                    if(y > 0)
+                        dirtyRows[y-1] |= colMask;
+                    dirtyRows[y] |= colMask;
+                    if(y < GPU_TILEMAP_TILE_SZ-1)
+                        dirtyRows[y+1] |= colMask;
+                }
+            }
+        }
+    }
+
+    for(int y=0;y<GPU_TILEMAP_TILE_SZ;y++)
+    {
+        for(int x=0;x<GPU_TILEMAP_TILE_SZ;x++)
+        {
+            int index = x + (y * GPU_TILEMAP_TILE_SZ);
+            uint8_t tileId = tileData[index] & cmd->tileIdMask;
+            entry->tileIds[index] = tileId;
+
+            if(!(dirtyRows[y] & (1 << x)))
+                continue;
+
+            struct GPUAttr_DrawTileMapData* tileInfo = tileId < tileInfosCnt ? &tileInfos[tileId] : 0;
+            for(int layerId=0;layerId<GPU_TILEMAP_CACHE_LAYERS;layerId++)
+            {
+                uint8_t resolvedTileId = 0xff;
+                if(tileInfo && tileInfo->isValid && layerId < tileInfo->layerCnt && tileInfo->layers[layerId].type == EGPUAttr_ETileRenderType_AutoTile)
+                    resolvedTileId = tilemap_resolve_autotile(tilemapDataBuffer, x, y, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask, tileInfo->layers[layerId].tileGroup);
+                entry->autoTileIds[layerId][index] = resolvedTileId;
+            }
+        }
+    }
+
+    // resolved at
+    entry->attribWriteCnt = tilemapAttribBuffer->writeCnt;
+    for(int i=0;i<9;i++)
+    {
+        struct GpuBufferInfo* edge = tilemap_cache_edge(tilemapDataBuffer, i);
+        entry->edges[i] = edge;
+        entry->edgeWriteCnts[i] = edge ? edge->writeCnt : 0;
+    }
+}
+
+
 void gpu_cmd_impl_DrawTileMap(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
 {
     GPUCMD_DrawTileMap* cmd = (GPUCMD_DrawTileMap*)header;
@@ -1326,7 +2734,23 @@ void gpu_cmd_impl_DrawTileMap(struct GpuState_t* gpu, struct GpuInstance_t* job,
 
     uint8_t* stateData = stateDataBuffer->basePtr;
     uint32_t stateDataCnt = stateDataBuffer->size / sizeof(uint8_t);
+
+    // autotiles resolved by prepare, stale or missing resolves per tile
+    const GpuTilemapCache_t* autoTileCache = tilemap_cache_find(gpu, tilemapDataBuffer, tilemapAttribBuffer, cmd->tileIdMask);
+    const uint16_t* seedPhases = tilemap_phases_find(gpu, cmd->seed);
+
+    // opaque tiles of last looked up layer frame, cells mostly share a few tile infos
+    struct GPUAttr_TileFrame* opaqueMemoFrame = 0;
+    uint64_t opaqueMemoTiles = 0;
         
+    // layer write mask, scratch is released by the dispatcher after the cmd
+    uint8_t* tileWriteMask = (uint8_t*)gpu_scratch_alloc(job, GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ);
+    if(!tileWriteMask)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Scratch alloc fail");
+        return;
+    }
+
 
     uint32_t localTileX = FLOOR_INT(-cmd->x, GPU_TILEMAP_TILE_SZ);
     uint32_t cmdTileCntX = CEIL_INT(cmd->x+cmd->w, GPU_TILEMAP_TILE_SZ);
@@ -1374,31 +2798,94 @@ void gpu_cmd_impl_DrawTileMap(struct GpuState_t* gpu, struct GpuInstance_t* job,
             if(!(tileInfo->tileGroup & cmd->tileGroupMask))
                 continue;
             
-            // render each layer
-            uint8_t tileWriteMask[16*16] = {0};
-
-            for(int layerId=0;layerId<tileInfo->layerCnt;layerId++)
+            // cell tables valid inside chunk
+            int cellIndex = tileX + tileStrideX;
+            bool inChunk = tileX < GPU_TILEMAP_TILE_SZ && tileY < GPU_TILEMAP_TILE_SZ;
+            const uint16_t* phases = inChunk ? seedPhases : 0;
+
+            // resolve layers top-down, layers under a fully opaque tile are never seen
+            uint8_t layerTileIds[GPU_TILE_MAX_LAYERS];     // resolved tile in 8x8 layer sheet, AutoTile & Decals
+            uint8_t layerFrameIds[GPU_TILE_MAX_LAYERS];
+            int layerCnt = tileInfo->layerCnt < GPU_TILE_MAX_LAYERS ? tileInfo->layerCnt : GPU_TILE_MAX_LAYERS;
+            int firstLayerId = 0;
+            bool maskedAbove = false;   // higher layer reads write mask, only AutoTile layers fill it
+            for(int layerId=layerCnt-1;layerId>=0;layerId--)
             {
                 struct GPUAttr_TileDataLayer* layer = &tileInfo->layers[layerId];
 
                 // resolve frame id
-                // TODO: cache this as same per layer
-
                 uint32_t frameOffset = 0;
                 if(layer->frameSeed)
-                {
-                    struct pseudo_random_t rng;
-                    pseudo_random_init(&rng); 
-                    pseudo_random_offset_seed(&rng, cmd->seed, cmd->seed); 
-                    pseudo_random_offset_seed(&rng, tileX, tileY); 
-                    frameOffset = pseudo_random_uint_range(&rng, 0, layer->tileFrameCnt);
-                }
+                    frameOffset = tilemap_frame_offset(phases, cmd->seed, tileX, tileY, layer->tileFrameCnt);
 
                 uint8_t frameId = 0xff;
                 if(layer->tileFrameCnt && layer->animFrameTime != 0)                 
                     frameId = layer->frameSeed + ( ((int)(cmd->time / layer->animFrameTime) + frameOffset) % layer->tileFrameCnt );            
-                
-                struct GPUAttr_TileFrame* frame = &layer->tileFrames[frameId < layer->tileFrameCnt ? frameId : 0];
+                layerFrameIds[layerId] = frameId < layer->tileFrameCnt ? frameId : 0;
+
+                // resolve tile
+                uint8_t resolvedTileId = 0xff;
+                bool coversTile = false;
+                switch(layer->type)
+                {
+                    case EGPUAttr_ETileRenderType_AutoTile:
+                    {
+                        // cached when neighbourhood unchanged
+                        if(autoTileCache && layerId < GPU_TILEMAP_CACHE_LAYERS && inChunk)
+                            resolvedTileId = autoTileCache->autoTileIds[layerId][cellIndex];
+                        if(resolvedTileId == 0xff)
+                            resolvedTileId = tilemap_resolve_autotile(tilemapDataBuffer, tileX, tileY, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask, layer->tileGroup);
+                        coversTile = true;
+                        break;
+                    }
+                    case EGPUAttr_ETileRenderType_Decals:
+                    {
+                        if(inChunk)
+                            resolvedTileId = tileDecalLookup[cellIndex];
+                        else
+                        {
+                            struct pseudo_random_t rng;
+                            pseudo_random_init(&rng); 
+                            pseudo_random_offset_seed(&rng, tileX, tileY); 
+                        
+                            int resolvedTileX = pseudo_random_uint_range(&rng, 0, 8);
+                            int resolvedTileY = pseudo_random_uint_range(&rng, 0, 8);
+                            resolvedTileId = resolvedTileX + (resolvedTileY * 8);
+                        }
+                        coversTile = !layer->maskPrevLayer && !maskedAbove;
+                        break;
+                    }
+                }
+                layerTileIds[layerId] = resolvedTileId;
+
+                // opaque tile, start here
+                uint8_t layerFrameId = layerFrameIds[layerId];
+                if(coversTile && layerFrameId < GPU_TILE_MAX_FRAMES && resolvedTileId < 64)
+                {
+                    struct GPUAttr_TileFrame* frame = &layer->tileFrames[layerFrameId];
+                    if(frame != opaqueMemoFrame)
+                    {
+                        opaqueMemoFrame = frame;
+                        opaqueMemoTiles = tilemap_opaque_find(gpu, layer, frame);
+                    }
+                    if((opaqueMemoTiles >> resolvedTileId) & 1)
+                    {
+                        firstLayerId = layerId;
+                        break;
+                    }
+                }
+
+                if(layer->maskPrevLayer)
+                    maskedAbove = true;
+            }
+
+            // render visible layers
+            memset(tileWriteMask, 0, GPU_TILEMAP_TILE_SZ*GPU_TILEMAP_TILE_SZ);
+
+            for(int layerId=firstLayerId;layerId<layerCnt;layerId++)
+            {
+                struct GPUAttr_TileDataLayer* layer = &tileInfo->layers[layerId];
+                struct GPUAttr_TileFrame* frame = &layer->tileFrames[layerFrameIds[layerId]];
                 
                 switch(layer->type)
                 {
@@ -1426,31 +2913,7 @@ void gpu_cmd_impl_DrawTileMap(struct GpuState_t* gpu, struct GpuInstance_t* job,
                         }   
                         uint16_t* srcBaseBuffer = (uint16_t*)baseTextureBuffer->basePtr;
 
-                        // resolve auto tile, sample tile (accross edges/chunks)
-                        uint32_t northWestVal = getTileGroup(tilemapDataBuffer, tileX - 1, tileY - 1, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-                        uint32_t northVal = getTileGroup(tilemapDataBuffer, tileX, tileY - 1, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-                        uint32_t northEastVal = getTileGroup(tilemapDataBuffer, tileX + 1, tileY - 1, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-                        uint32_t westVal = getTileGroup(tilemapDataBuffer, tileX - 1, tileY, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-                        uint32_t eastVal = getTileGroup(tilemapDataBuffer, tileX + 1, tileY, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-                        uint32_t southWestVal = getTileGroup(tilemapDataBuffer, tileX - 1, tileY + 1, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-                        uint32_t southVal = getTileGroup(tilemapDataBuffer, tileX, tileY + 1, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-                        uint32_t southEastVal = getTileGroup(tilemapDataBuffer, tileX + 1, tileY + 1, tileInfos, layerId, tileInfosCnt, cmd->tileIdMask) == layer->tileGroup;
-
-                        if (northVal == 0 || westVal == 0)
-                            northWestVal = 0;
-
-                        if (northVal == 0 || eastVal == 0)
-                            northEastVal = 0;
-
-                        if (southVal == 0 || westVal == 0)
-                            southWestVal = 0;
-
-                        if (southVal == 0 || eastVal == 0)
-                            southEastVal = 0;
-
-                        uint32_t autoTileId = (northWestVal * 1) + (northVal * 2) + (northEastVal * 4) + (westVal * 8) + (eastVal * 16) + (southWestVal * 32) + (southVal * 64) + (southEastVal * 128);
-
-                        int resolvedTileId = tileLookup[autoTileId];
+                        int resolvedTileId = layerTileIds[layerId];   // resolved top-down
                         int resolvedTileX = resolvedTileId % 8;
                         int resolvedTileY = FLOOR_INT(resolvedTileId, 8.0f);
 
@@ -1515,12 +2978,8 @@ void gpu_cmd_impl_DrawTileMap(struct GpuState_t* gpu, struct GpuInstance_t* job,
 
                         uint16_t* srcBaseBuffer = (uint16_t*)baseTextureBuffer->basePtr;
                         
-                        struct pseudo_random_t rng;
-                        pseudo_random_init(&rng); 
-                        pseudo_random_offset_seed(&rng, tileX, tileY); 
-                    
-                        int resolvedTileX = pseudo_random_uint_range(&rng, 0, 8);
-                        int resolvedTileY = pseudo_random_uint_range(&rng, 0, 8);
+                        int resolvedTileX = layerTileIds[layerId] % 8;
+                        int resolvedTileY = layerTileIds[layerId] / 8;
 
                         int tilebasePxX = (resolvedTileX * 16) + frame->x;
                         int tilebasePxY = (resolvedTileY * 16) + frame->y;
@@ -1586,11 +3045,16 @@ void gpu_cmd_impl_DrawTileMap(struct GpuState_t* gpu, struct GpuInstance_t* job,
 
                         uint16_t* srcBaseBuffer = (uint16_t*)baseTextureBuffer->basePtr;
                         
-                        struct pseudo_random_t rng;
-                        pseudo_random_init(&rng); 
-                        pseudo_random_offset_seed(&rng, tileX, tileY); 
-                    
-                        int rngVariant = pseudo_random_uint_range(&rng, 0, layer->numHTiles);
+                        int rngVariant;
+                        if(inChunk && layer->numHTiles && (GPU_TILE_PHASE_MOD % layer->numHTiles) == 0)
+                            rngVariant = tileVariantLookup[cellIndex] % layer->numHTiles;
+                        else
+                        {
+                            struct pseudo_random_t rng;
+                            pseudo_random_init(&rng); 
+                            pseudo_random_offset_seed(&rng, tileX, tileY); 
+                            rngVariant = pseudo_random_uint_range(&rng, 0, layer->numHTiles);
+                        }
                         if(rngVariant >= layer->numHTiles)
                             rngVariant = layer->numHTiles-1;
                         
@@ -1652,6 +3116,7 @@ void gpu_cmd_impl_DrawTileMap(struct GpuState_t* gpu, struct GpuInstance_t* job,
 void gpu_cmd_impl_CreateLinkedTilemapBuffer(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
 {
     GPUCMD_CreateLinkedTilemapBuffer* cmd = (GPUCMD_CreateLinkedTilemapBuffer*)header;
+    gpu->bufferWriteCnt++;
 
     if(cmd->tilemapDataBufferId >= GPU_MAX_BUFFER_ID)
     {
@@ -1734,6 +3199,143 @@ void gpu_cmd_impl_CreateLinkedTilemapBuffer(struct GpuState_t* gpu, struct GpuIn
 }
 
 
+// Water cell from its state & the cell above, shared by prepare & per tile fallback
+static uint8_t tilemap_fluid_cell(struct GpuBufferInfo* tilemapDataBuffer, struct GpuBufferInfo* stateDataBuffer, struct GPUAttr_DrawTileMapData* tileInfos, uint32_t tileInfosCnt, uint8_t tileIdMask, int tileX, int tileY)
+{
+    uint32_t index = tileX + (tileY * GPU_TILEMAP_TILE_SZ);
+    if(index >= tilemapDataBuffer->size || index >= stateDataBuffer->size)
+        return GPU_FLUID_CELL_SKIP;
+
+    uint8_t tileId = tilemapDataBuffer->basePtr[index] & tileIdMask;
+    if(tileId >= tileInfosCnt)
+        return GPU_FLUID_CELL_SKIP;
+
+    struct GPUAttr_DrawTileMapData* tileInfo = &tileInfos[tileId];
+    if(!tileInfo->isValid || tileInfo->overlayTileId >= tileInfosCnt || !tileInfos[tileInfo->overlayTileId].isValid)
+        return GPU_FLUID_CELL_SKIP;
+
+    // fluid above fills cell
+    if(getTileFluid(tilemapDataBuffer, stateDataBuffer, tileX, tileY - 1, tileInfos, tileInfosCnt, tileIdMask, 1) != 0)
+        return GPU_FLUID_CELL_LAYER_MASK | GPU_FLUID_CELL_ABOVE;
+
+    // layer determins state level
+    if(!tileInfo->layerCnt)
+        return GPU_FLUID_CELL_SKIP;
+    int layerId = (stateDataBuffer->basePtr[index] * tileInfo->layerCnt) / 255;
+    if(layerId >= tileInfo->layerCnt)
+        layerId = tileInfo->layerCnt - 1;
+    if(layerId >= GPU_TILE_MAX_LAYERS)
+        return GPU_FLUID_CELL_SKIP;
+    return layerId;
+}
+
+
+// Find fluid entry still valid for chunk, 0 evaluates per tile
+static const GpuFluidCache_t* tilemap_fluid_find(struct GpuState_t* gpu, struct GpuBufferInfo* tilemapDataBuffer, struct GpuBufferInfo* stateDataBuffer, struct GpuBufferInfo* tilemapAttribBuffer, uint8_t tileIdMask)
+{
+    if(!gpu->tilemapCaches)
+        return 0;
+    struct GpuBufferInfo* sources[4] = {tilemapDataBuffer, stateDataBuffer, tilemapDataBuffer->edgeData[1], stateDataBuffer->edgeData[1]};
+    for(int i=0;i<GPU_FLUID_CACHE_CNT;i++)
+    {
+        const GpuFluidCache_t* entry = &gpu->tilemapCaches->fluidCache[i];
+        if(entry->tilemapDataBuffer != tilemapDataBuffer || entry->stateDataBuffer != stateDataBuffer || entry->tilemapAttribBuffer != tilemapAttribBuffer || entry->tileIdMask != tileIdMask)
+            continue;
+
+        // written since prepare, eg. by this list
+        if(entry->attribWriteCnt != tilemapAttribBuffer->writeCnt)
+            return 0;
+        for(int j=0;j<4;j++)
+        {
+            if(sources[j] != entry->sources[j] || (sources[j] ? sources[j]->writeCnt : 0) != entry->sourceWriteCnts[j])
+                return 0;
+        }
+        return entry;
+    }
+    return 0;
+}
+
+
+// Evaluate chunk fluid neighbourhood before tiles run, once per chunk or state write
+void gpu_cmd_impl_DrawWater_prepare(struct GpuState_t* gpu, struct GpuCmd_Header* header)
+{
+    GPUCMD_DrawTileMap* cmd = (GPUCMD_DrawTileMap*)header;
+    GpuTilemapCaches_t* caches = gpu->tilemapCaches;
+    if(!caches || header->sz != sizeof(GPUCMD_DrawTileMap))
+        return;
+
+    struct GpuBufferInfo* tilemapDataBuffer = gpu_get_buffer_by_id(gpu, cmd->tilemapDataBufferId);
+    if(!tilemapDataBuffer || !tilemapDataBuffer->basePtr)
+        return;
+
+    struct GpuBufferInfo* stateDataBuffer = gpu_get_buffer_by_id(gpu, cmd->tilemapStateBufferId);
+    if(!stateDataBuffer || !stateDataBuffer->basePtr)
+        return;
+
+    struct GpuBufferInfo* tilemapAttribBuffer = gpu_get_buffer_by_id(gpu, cmd->tilemapAttribBufferId);
+    if(!tilemapAttribBuffer || !tilemapAttribBuffer->basePtr)
+        return;
+
+    struct GPUAttr_DrawTileMapData* tileInfos = (struct GPUAttr_DrawTileMapData*)tilemapAttribBuffer->basePtr;
+    uint32_t tileInfosCnt = tilemapAttribBuffer->size / sizeof(struct GPUAttr_DrawTileMapData);
+
+    // find chunk or evict oldest
+    caches->prepareCnt++;
+    tilemap_phases_prepare(caches, cmd->seed);
+    GpuFluidCache_t* entry = 0;
+    GpuFluidCache_t* oldest = &caches->fluidCache[0];
+    for(int i=0;i<GPU_FLUID_CACHE_CNT;i++)
+    {
+        GpuFluidCache_t* it = &caches->fluidCache[i];
+        if(it->tilemapDataBuffer == tilemapDataBuffer && it->stateDataBuffer == stateDataBuffer && it->tilemapAttribBuffer == tilemapAttribBuffer && it->tileIdMask == cmd->tileIdMask)
+        {
+            entry = it;
+            break;
+        }
+        if(it->lastPrepareId < oldest->lastPrepareId)
+            oldest = it;
+    }
+
+    bool evaluate = false;
+    if(!entry)
+    {
+        entry = oldest;
+        entry->tilemapDataBuffer = tilemapDataBuffer;
+        entry->stateDataBuffer = stateDataBuffer;
+        entry->tilemapAttribBuffer = tilemapAttribBuffer;
+        entry->tileIdMask = cmd->tileIdMask;
+        evaluate = true;
+    }
+    entry->lastPrepareId = caches->prepareCnt;
+
+    // cells only read own state & the cell above
+    struct GpuBufferInfo* sources[4] = {tilemapDataBuffer, stateDataBuffer, tilemapDataBuffer->edgeData[1], stateDataBuffer->edgeData[1]};
+    if(entry->attribWriteCnt != tilemapAttribBuffer->writeCnt)
+        evaluate = true;
+    for(int i=0;i<4;i++)
+    {
+        if(entry->sources[i] != sources[i] || (sources[i] ? sources[i]->writeCnt : 0) != entry->sourceWriteCnts[i])
+            evaluate = true;
+    }
+    if(!evaluate)
+        return;
+
+    for(int y=0;y<GPU_TILEMAP_TILE_SZ;y++)
+    {
+        for(int x=0;x<GPU_TILEMAP_TILE_SZ;x++)
+            entry->cells[x + (y * GPU_TILEMAP_TILE_SZ)] = tilemap_fluid_cell(tilemapDataBuffer, stateDataBuffer, tileInfos, tileInfosCnt, cmd->tileIdMask, x, y);
+    }
+
+    // evaluated at
+    entry->attribWriteCnt = tilemapAttribBuffer->writeCnt;
+    for(int i=0;i<4;i++)
+    {
+        entry->sources[i] = sources[i];
+        entry->sourceWriteCnts[i] = sources[i] ? sources[i]->writeCnt : 0;
+    }
+}
+
+
 void gpu_cmd_impl_DrawWater(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
 {
     GPUCMD_DrawTileMap* cmd = (GPUCMD_DrawTileMap*)header;
@@ -1765,14 +3367,16 @@ void gpu_cmd_impl_DrawWater(struct GpuState_t* gpu, struct GpuInstance_t* job, s
     uint32_t tileInfosCnt = tilemapAttribBuffer->size / sizeof(struct GPUAttr_DrawTileMapData);
 
     uint8_t* tileData = tilemapDataBuffer->basePtr;
-    uint32_t tileDataCnt = tilemapDataBuffer->size / sizeof(uint8_t);
 
-    uint8_t* stateData = stateDataBuffer->basePtr;
-    uint32_t stateDataCnt = stateDataBuffer->size / sizeof(uint8_t);
+    // fluid cells & phases from prepare, stale or missing evaluates per tile
+    const GpuFluidCache_t* fluidCache = tilemap_fluid_find(gpu, tilemapDataBuffer, stateDataBuffer, tilemapAttribBuffer, cmd->tileIdMask);
+    const uint16_t* seedPhases = tilemap_phases_find(gpu, cmd->seed);
 
-    struct pseudo_random_t rng;
-    pseudo_random_init(&rng); 
-    pseudo_random_offset_seed(&rng, cmd->seed, cmd->seed); 
+    // anim ticks, water layers mostly share frame times so time only divides when it changes
+    float baseFrameTime = 0;
+    float overlayFrameTime = 0;
+    int baseTick = 0;
+    int overlayTick = 0;
 
     uint32_t localTileX = FLOOR_INT(-cmd->x, GPU_TILEMAP_TILE_SZ);
     uint32_t cmdTileCntX = CEIL_INT(cmd->x+cmd->w, GPU_TILEMAP_TILE_SZ);
@@ -1782,89 +3386,72 @@ void gpu_cmd_impl_DrawWater(struct GpuState_t* gpu, struct GpuInstance_t* job, s
         cmdTileCntX = GPU_TILEMAP_TILE_SZ; 
 
     uint32_t localTileY = FLOOR_INT(-(cmd->y - fb->y), GPU_TILEMAP_TILE_SZ);
-    uint32_t cmdTileCntY = CEIL_INT(cmd->y+cmd->h, GPU_TILEMAP_TILE_SZ);    
-
     if(localTileY > GPU_TILEMAP_TILE_SZ)
         localTileY = 0;
-    if(cmdTileCntY > GPU_TILEMAP_TILE_SZ)
-        cmdTileCntY = GPU_TILEMAP_TILE_SZ; 
 
     int tileYCnt = localTileY+ ((FRAME_TILE_SZ_Y / 16));
 
-    // Tile y loop    
-    for(int tileY=localTileY;tileY<=tileYCnt;tileY++)
+    // tiles overdraw neighbours
+    const int overdrawOffsetSub = 4;
+    const int cellSz = GPU_TILEMAP_TILE_SZ + (overdrawOffsetSub*2);
+    const int srcOffset = GPU_TILEMAP_TILE_SZ - overdrawOffsetSub;
+
+    // Tile y loop, cells outside chunk are never drawn
+    for(int tileY=localTileY;tileY<=tileYCnt && tileY<GPU_TILEMAP_TILE_SZ;tileY++)
     {
         int tileStrideX = (tileY * GPU_TILEMAP_TILE_SZ);
-        int tileBaseY = tileY * GPU_TILEMAP_TILE_SZ;
-        int pixelBaseY = (cmd->y + tileBaseY) - fb->y;
-
-        int pixelStartY = 0;   
-        if(pixelBaseY < 0)
-            pixelStartY = -pixelBaseY;
-
-        if(pixelStartY > FRAME_TILE_SZ_Y)
+        int pixelBaseY = (cmd->y + (tileY * GPU_TILEMAP_TILE_SZ)) - fb->y;
+        if(pixelBaseY < -FRAME_TILE_SZ_Y)
             break;
 
+        // cell rows inside tile frame
+        int y0 = MAX(0, overdrawOffsetSub - pixelBaseY);
+        int y1 = MIN(cellSz, (int)fb->h - pixelBaseY + overdrawOffsetSub);
+        if(y0 >= y1)
+            continue;
+
         // tile X loop        
-        for(int tileX=localTileX;tileX<localTileX+cmdTileCntX;tileX++)
+        for(int tileX=localTileX;tileX<localTileX+cmdTileCntX && tileX<GPU_TILEMAP_TILE_SZ;tileX++)
         {       
-            int tileBaseX = tileX * GPU_TILEMAP_TILE_SZ;            
-            int pixelBaseX = cmd->x + tileBaseX;
-            
-            // calc start pixel X ()
-            int pixelStartX = 0;   
-            if(pixelBaseX < 0)
-                pixelStartX = -pixelBaseX;
-            int pixelCntY = GPU_TILEMAP_TILE_SZ;
-
-            if(pixelStartX > FRAME_W)
+            int pixelBaseX = cmd->x + (tileX * GPU_TILEMAP_TILE_SZ);
+            if(pixelBaseX < -FRAME_W)
                 break;
-            
-            uint8_t tileId = tileData[ tileX + (tileY*16) ];            
-            uint8_t state = stateData[ tileX + (tileY*16) ];
-            struct GPUAttr_DrawTileMapData* tileInfo = &tileInfos[ tileId & cmd->tileIdMask ];
-            if(!tileInfo->isValid)
+
+            // cell cols inside tile frame
+            int x0 = MAX(0, overdrawOffsetSub - pixelBaseX);
+            int x1 = MIN(cellSz, (int)fb->w - pixelBaseX + overdrawOffsetSub);
+            if(x0 >= x1)
                 continue;
-            struct GPUAttr_DrawTileMapData* overlayTileInfo = &tileInfos[ tileInfo->overlayTileId ];
-            if(!overlayTileInfo->isValid)
-                continue;                
-            
+
+            int cellIndex = tileX + tileStrideX;
+            uint8_t cell = fluidCache ? fluidCache->cells[cellIndex] : tilemap_fluid_cell(tilemapDataBuffer, stateDataBuffer, tileInfos, tileInfosCnt, cmd->tileIdMask, tileX, tileY);
+            if(cell & GPU_FLUID_CELL_SKIP)
+                continue;
+
+            struct GPUAttr_DrawTileMapData* tileInfo = &tileInfos[ tileData[cellIndex] & cmd->tileIdMask ];
             if(!(tileInfo->tileGroup & cmd->tileGroupMask))
                 continue;                
-            
-            // layer determins state level
-            int layerId = (state / 255.0f) * tileInfo->layerCnt;
-            if(layerId >= tileInfo->layerCnt)
-                layerId = tileInfo->layerCnt - 1;
-
-            // detect edges type
-            uint8_t fluidAbove = getTileFluid( tilemapDataBuffer, stateDataBuffer, tileX + 0, tileY - 1, tileInfos, tileInfosCnt, cmd->tileIdMask, 1 );
-            uint8_t fluidBelow = getTileFluid( tilemapDataBuffer, stateDataBuffer, tileX + 0, tileY + 1, tileInfos, tileInfosCnt, cmd->tileIdMask, 1 );
-            if(fluidAbove != 0)
-            {                
-                layerId = 7; // fill above
-            }
+            struct GPUAttr_DrawTileMapData* overlayTileInfo = &tileInfos[ tileInfo->overlayTileId ];
 
-            if( layerId >= NUM_ELEMS(tileInfo->layers))
-            {
-                gpu_error(gpu, job, EGpuErrorCode_General, "layerId >= NUM_ELEMS(tileInfo->layers)" );
-                return;
-            }
-            
-            struct GPUAttr_TileDataLayer* layer = &tileInfo->layers[layerId];
+            bool fluidAbove = (cell & GPU_FLUID_CELL_ABOVE) != 0;
+            struct GPUAttr_TileDataLayer* layer = &tileInfo->layers[cell & GPU_FLUID_CELL_LAYER_MASK];
 
             // get anim frame
             uint32_t frameOffset = 0;
             if(layer->frameSeed)
-            {
-                frameOffset = pseudo_random_uint_range(&rng, 0, layer->tileFrameCnt);
-            }
+                frameOffset = tilemap_frame_offset(seedPhases, cmd->seed, tileX, tileY, layer->tileFrameCnt);
 
             uint8_t frameId = 0xff;
             if(layer->tileFrameCnt && layer->animFrameTime != 0)                 
-                frameId = layer->frameSeed + ( ((int)(cmd->time / layer->animFrameTime) + frameOffset) % layer->tileFrameCnt );                              
- 
-            struct GPUAttr_TileFrame* frame = &layer->tileFrames[frameId <= layer->tileFrameCnt ? frameId : 0];            
+            {
+                if(layer->animFrameTime != baseFrameTime)
+                {
+                    baseFrameTime = layer->animFrameTime;
+                    baseTick = (int)(cmd->time / baseFrameTime);
+                }
+                frameId = layer->frameSeed + ( (baseTick + frameOffset) % layer->tileFrameCnt );                              
+            }
+            struct GPUAttr_TileFrame* frame = &layer->tileFrames[frameId < layer->tileFrameCnt ? frameId : 0];            
 
             if( layer->textureBufferId >= NUM_ELEMS(gpu->buffers) )
             {
@@ -1873,8 +3460,8 @@ void gpu_cmd_impl_DrawWater(struct GpuState_t* gpu, struct GpuInstance_t* job, s
             }
 
             // base tilemap texture
-            struct GpuBufferInfo* baseTextureBuffer =  &gpu->buffers[ layer->textureBufferId ]; //gpu_get_buffer_by_id( gpu, layer->textureBufferId );
-            if(!baseTextureBuffer)
+            struct GpuBufferInfo* baseTextureBuffer = &gpu->buffers[ layer->textureBufferId ];
+            if(!baseTextureBuffer->basePtr)
             {
                 gpu_error(gpu, job, EGpuErrorCode_General, "Tilemap missing layer texture");
                 return;
@@ -1884,15 +3471,14 @@ void gpu_cmd_impl_DrawWater(struct GpuState_t* gpu, struct GpuInstance_t* job, s
                 gpu_error(gpu, job, EGpuErrorCode_General, "Water tilemaps requires 8BPP mapped tiles");
                 return;
             }
-            uint8_t* srcBaseBuffer = (uint8_t*)baseTextureBuffer->basePtr;
 
-
-            struct GpuBufferInfo* palBuffer =  &gpu->buffers[layer->palBufferId ];; //gpu_get_buffer_by_id( gpu, layer->palBufferId );
-            if(!palBuffer)
+            if( layer->palBufferId >= NUM_ELEMS(gpu->buffers) )
             {
-                gpu_error(gpu, job, EGpuErrorCode_General, "Tilemap missing layer texture");
+                gpu_error(gpu, job, EGpuErrorCode_General, "layer->palBufferId >= NUM_ELEMS(gpu->buffers)");
                 return;
             }
+
+            struct GpuBufferInfo* palBuffer = &gpu->buffers[ layer->palBufferId ];
             if(palBuffer->textureFormat != ETextureFormat_RGB16)
             {
                 gpu_error(gpu, job, EGpuErrorCode_General, "Water tilemaps palette requires 16BPP");
@@ -1900,125 +3486,95 @@ void gpu_cmd_impl_DrawWater(struct GpuState_t* gpu, struct GpuInstance_t* job, s
             }
 
             uint32_t palDataSz = palBuffer->size / sizeof(uint16_t);
-            uint16_t* palData = (uint16_t*)palBuffer->basePtr;
+            const uint16_t* palData = (const uint16_t*)palBuffer->basePtr;
+            if(!palData || !palDataSz)
+            {
+                gpu_error(gpu, job, EGpuErrorCode_General, "Water tilemaps palette missing or empty");
+                return;
+            }
 
-            // get overlay 
-            uint32_t overlayVariantLayerId = 0;
-            struct GPUAttr_TileDataLayer* overlayLayer = &overlayTileInfo->layers[overlayVariantLayerId];
+            // get overlay
+            struct GPUAttr_TileDataLayer* overlayLayer = &overlayTileInfo->layers[0];
+            if( overlayLayer->textureBufferId >= NUM_ELEMS(gpu->buffers) )
+            {
+                gpu_error(gpu, job, EGpuErrorCode_General, "overlayLayer->textureBufferId >= NUM_ELEMS(gpu->buffers)");
+                return;
+            }
 
-            struct GpuBufferInfo* overlayTextureBuffer =  &gpu->buffers[overlayLayer->textureBufferId ]; //gpu_get_buffer_by_id(gpu, overlayLayer->textureBufferId);
-            if(!overlayTextureBuffer)
+            struct GpuBufferInfo* overlayTextureBuffer = &gpu->buffers[ overlayLayer->textureBufferId ];
+            if(!overlayTextureBuffer->basePtr)
             {
                 gpu_error(gpu, job, EGpuErrorCode_General, "Overlay missing layer texture");
                 return;
             }
-            uint8_t* overlayBaseBuffer = (uint8_t*)overlayTextureBuffer->basePtr;
 
             uint32_t overlayFrameOffset = 0;
             if(overlayLayer->frameSeed)
-            {
-               overlayFrameOffset = pseudo_random_uint_range(&rng, 0, overlayLayer->tileFrameCnt);
-            }
+                overlayFrameOffset = tilemap_frame_offset(seedPhases, cmd->seed, tileX, tileY, overlayLayer->tileFrameCnt);
 
             uint8_t overlayFrameId = 0xff;
             if(overlayLayer->tileFrameCnt && overlayLayer->animFrameTime != 0)            
             {     
-                overlayFrameId =  overlayLayer->frameSeed + ( ((int)(cmd->time / overlayLayer->animFrameTime) + overlayFrameOffset) );               
+                if(overlayLayer->animFrameTime != overlayFrameTime)
+                {
+                    overlayFrameTime = overlayLayer->animFrameTime;
+                    overlayTick = (int)(cmd->time / overlayFrameTime);
+                }
+                overlayFrameId = overlayLayer->frameSeed + overlayTick + overlayFrameOffset;               
                 overlayFrameId = overlayFrameId % overlayLayer->tileFrameCnt;
             }
-
             struct GPUAttr_TileFrame* overlayFrame = &overlayLayer->tileFrames[overlayFrameId < overlayLayer->tileFrameCnt ? overlayFrameId : 0];                        
 
-            // TODO: tile attr
-            int overdrawOffsetSub = 4;
+            // blend policy, first water write to a pixel wins
+            uint8_t a = tileInfo->writeAlpha | GPU_ATTR_PIXELWRITE0_MASK;
+            bool blendAdditive = tileInfo->blendAdditive;
 
-            for(int y=0;y<16+(overdrawOffsetSub*2);y++)            
+            const uint8_t* srcRow = baseTextureBuffer->basePtr + srcOffset + ((frame->y + srcOffset + y0) * baseTextureBuffer->w);
+            const uint8_t* overlayRow = overlayTextureBuffer->basePtr + srcOffset + ((overlayFrame->y + srcOffset + y0) * overlayTextureBuffer->w);
+            int rowIndex = ((pixelBaseY - overdrawOffsetSub + y0) * fb->w) + pixelBaseX - overdrawOffsetSub;
+            for(int y=y0;y<y1;y++, srcRow += baseTextureBuffer->w, overlayRow += overlayTextureBuffer->w, rowIndex += fb->w)            
             {                        
-                int yy = y-overdrawOffsetSub;
-                int localY = pixelBaseY + yy;
-                if(localY >= (int)fb->h)
-                {
-                    break;
-                }
-                if(localY < 0)
-                    continue;
-
-                for(int x=0;x<16+(overdrawOffsetSub*2);x++)                
+                uint16_t* dst = pixels + rowIndex;
+                uint8_t* attr = fb->attr + rowIndex;
+                for(int x=x0;x<x1;x++)                
                 {                              
-                    uint8_t colId = srcBaseBuffer[ x + (16-overdrawOffsetSub)  + ((frame->y + y + (16-overdrawOffsetSub)) * baseTextureBuffer->w) ];                    
-                    if(colId > palDataSz)
-                        colId = 0;
+                    uint8_t colId = srcRow[x];
 
                     // wave replace
-                    if(!(fluidAbove == 0))
-                    {
-                        if((colId ==1))
-                        {
-                            colId = 2;
-                        }
-                    }
+                    if(fluidAbove && colId == 1)
+                        colId = 2;
+                    if(colId >= palDataSz)
+                        colId = 0;
 
                     uint16_t col = palData[colId];      
-                    uint16_t overlayCol = palData[ overlayBaseBuffer[ x + (16-overdrawOffsetSub) + ((overlayFrame->y + y + (16-overdrawOffsetSub)) * overlayTextureBuffer->w) ] ];
-                    
-                    if(col)
-                    {                           
-                        int xx = x-overdrawOffsetSub;
+                    if(!col)
+                        continue;
 
-                        int pixelRowStride = (localY * fb->w);
-                        int localX = pixelBaseX + xx;
-                        if(localX >= fb->w)
-                            continue;   // break -> speed up but loss
+                    // water pixel already written
+                    if(attr[x] & GPU_ATTR_PIXELWRITE0_MASK)
+                        continue;
 
-                        int index = localX + pixelRowStride;                        
+                    uint8_t overlayColId = overlayRow[x];
+                    uint16_t overlayCol = overlayColId < palDataSz ? palData[overlayColId] : 0;
 
-                        // blend policy
-                        if(fb->attr[ index ] & GPU_ATTR_PIXELWRITE0_MASK) // water pixel already written
-                        {
-                            continue; // reject
-                        }
-                        else
-                        {                   
-                            // Alpha                            
-                            uint8_t a = tileInfo->writeAlpha | GPU_ATTR_PIXELWRITE0_MASK;
-
-                            // Addive
-                            if( tileInfo->blendAdditive)
-                            {
-                                col = gpu_col_add_uint16(pixels[ index ], col );   
-                                
-                                if((fb->attr[index] & GPU_ATTR_ALPHA_MASK) == 0)
-                                {
-                                    // set alpha bits if transparent
-                                    fb->attr[index] = a | GPU_ATTR_PIXELWRITE0_MASK;
-                                }
-                            } 
-                            else
-                            {                                
-                                // blend into fb
-                                col = ALPHA_BLIT16_565(col, pixels[index], a);
+                    if(blendAdditive)
+                        col = gpu_col_add_uint16(dst[x], col);
+                    else
+                        col = gpu_col_blend_uint16(col, dst[x], a);
 
-                                if((fb->attr[index] & GPU_ATTR_ALPHA_MASK) == 0)
-                                {
-                                    // set alpha bits if transparent
-                                    fb->attr[index] = a | GPU_ATTR_PIXELWRITE0_MASK;
-                                }
-                            }
+                    // set alpha bits if transparent
+                    if((attr[x] & GPU_ATTR_ALPHA_MASK) == 0)
+                        attr[x] = a;
 
-                            // enforce hilites
-                            if(overlayCol)
-                            {
-                                col = gpu_col_add_uint16(pixels[ index ], overlayCol );                        
-                            }
-                            
-                            if(colId == 1) // wave overlay
-                            {
-                                col = gpu_col_add_uint16(pixels[ index ], col );                      
-                            }
+                    // enforce hilites
+                    if(overlayCol)
+                        col = gpu_col_add_uint16(dst[x], overlayCol);
 
-                            pixels[index] = col;                           
-                        }
-                    }
+                    // wave overlay
+                    if(colId == 1)
+                        col = gpu_col_add_uint16(dst[x], col);
+
+                    dst[x] = col;
                 }
             }
         }
@@ -2118,7 +3674,7 @@ void gpu_cmd_impl_CompositeTile(struct GpuState_t* gpu, struct GpuInstance_t* jo
                 uint8_t attr = *(attrPixelsRow++);
                 uint8_t a = (attr & GPU_ATTR_ALPHA_MASK) * 17;
                 
-                dstRow[i] = ALPHA_BLIT16_565(c, dstRow[i], a);            
+                dstRow[i] = gpu_col_blend_uint16(c, dstRow[i], a);            
             }
             break;
         }
@@ -2136,7 +3692,7 @@ void gpu_cmd_impl_CompositeTile(struct GpuState_t* gpu, struct GpuInstance_t* jo
                 uint8_t a = (attr & GPU_ATTR_ALPHA_MASK) * 16;
 
                 // debug alpha
-                dstRow[i] = gpu_col_from_rgbf(a/255.0f, 0, 0).value;  
+                dstRow[i] = gpu_col_pack_uint16((a * COL16_MAX_R) / 255, 0, 0);  
             }
             break;
         }       
@@ -2154,7 +3710,7 @@ void gpu_cmd_impl_CompositeTile(struct GpuState_t* gpu, struct GpuInstance_t* jo
                 uint8_t a = (attr & GPU_ATTR_PIXELWRITE0_MASK) ? 0xff : 0;
 
                 // debug alpha
-                dstRow[i] = gpu_col_from_rgbf(a/255.0f, 0, 0).value;  
+                dstRow[i] = gpu_col_pack_uint16((a * COL16_MAX_R) / 255, 0, 0);  
             }        
             break;
         }      
@@ -2277,6 +3833,113 @@ bool toString_gpu_cmd_impl_DrawLine(const struct GpuState_t* gpu, struct GpuCmd_
 }
 
 
+//
+// Cmd lists
+void gpu_cmd_impl_CallCmdList(struct GpuState_t* gpu, struct GpuInstance_t* job, struct GpuCmd_Header* header, TileFrameBuffer_t* fb)
+{
+    struct GPUCMD_CallCmdList* cmd = (GPUCMD_CallCmdList*)header;
+    struct GpuBufferInfo* buffer = gpu_get_buffer_by_id(gpu, cmd->bufferId);
+    if(!buffer || buffer->textureFormat != ETextureFormat_CmdList)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_InvalidBufferId, "Invalid cmd list buffer");
+        return;
+    }
+
+    // validated on upload by WriteBufferData
+    if(!buffer->cmdListValid)
+    {
+        gpu_error(gpu, job, EGpuErrorCode_General, "Cmd list failed validation");
+        return;
+    }
+
+    gpu_run_tile_cmd_list_buffer(gpu, job, buffer, fb, cmd->offsetX, cmd->offsetY);
+}
+
+
+bool validate_gpu_cmd_impl_CallCmdList(const struct GpuState_t* gpu, struct GpuCmd_Header* header, struct GpuValidationOutput_t* info)
+{
+    struct GPUCMD_CallCmdList* cmd = (GPUCMD_CallCmdList*)header;
+
+    GPU_VALIDATE_ASSERT(header->sz == sizeof(GPUCMD_CallCmdList));            
+    GPU_VALIDATE_ASSERT(cmd->bufferId < GPU_MAX_BUFFER_ID);
+        
+    info->extraArg0 = cmd->bufferId;
+    return true;
+}
+
+
+bool toString_gpu_cmd_impl_CallCmdList(const struct GpuState_t* gpu, struct GpuCmd_Header* header, char* buff, uint32_t buffSz)
+{
+    struct GPUCMD_CallCmdList* cmd = (GPUCMD_CallCmdList*)header;
+    sprintf(buff, "bufferId:%d, offsetX:%d, offsetY:%d", 
+            cmd->bufferId,
+            cmd->offsetX,
+            cmd->offsetY);   
+    return true;
+}
+
+
+void translate_gpu_cmd_impl_FillRectCol(struct GpuCmd_Header* header, int16_t dx, int16_t dy)
+{
+    struct GPUCMD_FillRectCol* cmd = (GPUCMD_FillRectCol*)header;
+    cmd->x += dx;
+    cmd->y += dy;
+}
+
+
+void translate_gpu_cmd_impl_BlitRect(struct GpuCmd_Header* header, int16_t dx, int16_t dy)
+{
+    struct GPUCMD_BlitRect* cmd = (GPUCMD_BlitRect*)header;
+    cmd->dstX += dx;
+    cmd->dstY += dy;
+}
+
+
+void translate_gpu_cmd_impl_BlitRectAffine(struct GpuCmd_Header* header, int16_t dx, int16_t dy)
+{
+    // xform is relative to dst bounds
+    struct GPUCMD_BlitRectAffine* cmd = (GPUCMD_BlitRectAffine*)header;
+    cmd->dstX += dx;
+    cmd->dstY += dy;
+}
+
+
+void translate_gpu_cmd_impl_BlitTile(struct GpuCmd_Header* header, int16_t dx, int16_t dy)
+{
+    struct GPUCMD_BlitTile* cmd = (GPUCMD_BlitTile*)header;
+    cmd->dstX += dx;
+    cmd->dstY += dy;
+}
+
+
+void translate_gpu_cmd_impl_DrawSpriteBatch(struct GpuCmd_Header* header, int16_t dx, int16_t dy)
+{
+    struct GPUCMD_DrawSpriteBatch* cmd = (GPUCMD_DrawSpriteBatch*)header;
+    for(int i=0;i<cmd->instanceCnt;i++)
+    {
+        cmd->instances[i].x += dx;
+        cmd->instances[i].y += dy;
+    }
+}
+
+
+void translate_gpu_cmd_impl_DrawTileMap(struct GpuCmd_Header* header, int16_t dx, int16_t dy)
+{
+    struct GPUCMD_DrawTileMap* cmd = (GPUCMD_DrawTileMap*)header;
+    cmd->x += dx;
+    cmd->y += dy;
+}
+
+
+void translate_gpu_cmd_impl_DrawLine(struct GpuCmd_Header* header, int16_t dx, int16_t dy)
+{
+    struct GPUCMD_DrawLine* cmd = (GPUCMD_DrawLine*)header;
+    cmd->x0 += dx;
+    cmd->y0 += dy;
+    cmd->x1 += dx;
+    cmd->y1 += dy;
+}
+
 void gpu_init_commands_3d(GpuState_t* state);
 void gpu_init_commands(GpuState_t* state)
 {   
@@ -2284,21 +3947,27 @@ void gpu_init_commands(GpuState_t* state)
     if(!lazyInit)
     {
         initTilemap();
+        initTileDecals();
         lazyInit = 1;
     }
 
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="ResetGpu", .id=EGPUCMD_ResetGpu, .cmd=gpu_cmd_impl_ResetGpu, .validator=validate_gpu_cmd_impl_ResetGpu, .toString=0});     
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="ResetGpu", .id=EGPUCMD_ResetGpu, .cmd=gpu_cmd_impl_ResetGpu, .writesBuffers=true, .validator=validate_gpu_cmd_impl_ResetGpu, .toString=0});     
     gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="SetDebug", .id=EGPUCMD_SetDebug, .cmd=gpu_cmd_impl_SetDebug, .validator=validate_gpu_cmd_impl_SetDebug, .toString=0});           
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="FillRectCol", .id=EGPUCMD_FillRectCol, .cmd=gpu_cmd_impl_FillRectCol, .validator=validate_gpu_cmd_impl_FillRectCol, .toString=0});     
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="CreateBuffer", .id=EGPUCMD_CreateBuffer, .cmd=gpu_cmd_impl_CreateBuffer, .validator=validate_gpu_cmd_impl_CreateBuffer, .toString=toString_gpu_cmd_impl_CreateBuffer});
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="WriteBufferData", .id=EGPUCMD_WriteBufferData, .cmd=gpu_cmd_impl_WriteBufferData, .validator=validate_gpu_cmd_impl_WriteBufferData, .toString=toString_gpu_cmd_impl_WriteBufferData});
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="RegisterCmd", .id=EGPUCMD_RegisterCmd, .cmd=gpu_cmd_impl_RegisterCmd, .validator=validate_gpu_cmd_impl_RegisterCmd, .toString=0});
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="BlitRect", .id=EGPUCMD_BlitRect, .cmd=gpu_cmd_impl_BlitRect, .validator=validate_gpu_cmd_impl_BlitRect, .toString=toString_gpu_cmd_impl_BlitRect});         
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawTileMap", .id=EGPUCMD_DrawTileMap, .cmd=gpu_cmd_impl_DrawTileMap, .validator=0, .toString=0});            
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawWater", .id=EGPUCMD_DrawWater, .cmd=gpu_cmd_impl_DrawWater, .validator=0, .toString=0});            
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="CreateLinkedTilemapBuffer", .id=EGPUCMD_CreateLinkedTilemapBuffer, .cmd=gpu_cmd_impl_CreateLinkedTilemapBuffer, .validator=0, .toString=0});            
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="FillRectCol", .id=EGPUCMD_FillRectCol, .cmd=gpu_cmd_impl_FillRectCol, .validator=validate_gpu_cmd_impl_FillRectCol, .toString=0, .translate=translate_gpu_cmd_impl_FillRectCol});     
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="CreateBuffer", .id=EGPUCMD_CreateBuffer, .cmd=gpu_cmd_impl_CreateBuffer, .writesBuffers=true, .validator=validate_gpu_cmd_impl_CreateBuffer, .toString=toString_gpu_cmd_impl_CreateBuffer});
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="WriteBufferData", .id=EGPUCMD_WriteBufferData, .cmd=gpu_cmd_impl_WriteBufferData, .writesBuffers=true, .validator=validate_gpu_cmd_impl_WriteBufferData, .toString=toString_gpu_cmd_impl_WriteBufferData});
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="RegisterCmd", .id=EGPUCMD_RegisterCmd, .cmd=gpu_cmd_impl_RegisterCmd, .writesBuffers=true, .validator=validate_gpu_cmd_impl_RegisterCmd, .toString=0});
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="BlitRect", .id=EGPUCMD_BlitRect, .cmd=gpu_cmd_impl_BlitRect, .cmdUnchecked=gpu_cmd_impl_BlitRect_unchecked, .validator=validate_gpu_cmd_impl_BlitRect, .toString=toString_gpu_cmd_impl_BlitRect, .translate=translate_gpu_cmd_impl_BlitRect});         
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="BlitRectAffine", .id=EGPUCMD_BlitRectAffine, .cmd=gpu_cmd_impl_BlitRectAffine, .validator=validate_gpu_cmd_impl_BlitRectAffine, .toString=toString_gpu_cmd_impl_BlitRectAffine, .translate=translate_gpu_cmd_impl_BlitRectAffine});         
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="BlitTile", .id=EGPUCMD_BlitTile, .cmd=gpu_cmd_impl_BlitTile, .validator=validate_gpu_cmd_impl_BlitTile, .toString=toString_gpu_cmd_impl_BlitTile, .translate=translate_gpu_cmd_impl_BlitTile});         
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawScrollLayer", .id=EGPUCMD_DrawScrollLayer, .cmd=gpu_cmd_impl_DrawScrollLayer, .validator=validate_gpu_cmd_impl_DrawScrollLayer, .toString=toString_gpu_cmd_impl_DrawScrollLayer});         
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawSpriteBatch", .id=EGPUCMD_DrawSpriteBatch, .cmd=gpu_cmd_impl_DrawSpriteBatch, .cmdUnchecked=gpu_cmd_impl_DrawSpriteBatch_unchecked, .validator=validate_gpu_cmd_impl_DrawSpriteBatch, .toString=toString_gpu_cmd_impl_DrawSpriteBatch, .translate=translate_gpu_cmd_impl_DrawSpriteBatch});         
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawTileMap", .id=EGPUCMD_DrawTileMap, .cmd=gpu_cmd_impl_DrawTileMap, .validator=0, .toString=0, .translate=translate_gpu_cmd_impl_DrawTileMap, .prepare=gpu_cmd_impl_DrawTileMap_prepare});            
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawWater", .id=EGPUCMD_DrawWater, .cmd=gpu_cmd_impl_DrawWater, .validator=0, .toString=0, .translate=translate_gpu_cmd_impl_DrawTileMap, .prepare=gpu_cmd_impl_DrawWater_prepare});            
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="CreateLinkedTilemapBuffer", .id=EGPUCMD_CreateLinkedTilemapBuffer, .cmd=gpu_cmd_impl_CreateLinkedTilemapBuffer, .writesBuffers=true, .validator=0, .toString=0});            
     gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="CompositeTile", .id=EGPUCMD_CompositeTile, .cmd=gpu_cmd_impl_CompositeTile, .validator=0, .toString=0});                
-    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawLine", .id=EGPUCMD_DrawLine, .cmd=gpu_cmd_impl_DrawLine, .validator=validate_gpu_cmd_impl_DrawLine, .toString=toString_gpu_cmd_impl_DrawLine});
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="CallCmdList", .id=EGPUCMD_CallCmdList, .cmd=gpu_cmd_impl_CallCmdList, .validator=validate_gpu_cmd_impl_CallCmdList, .toString=toString_gpu_cmd_impl_CallCmdList});
+    gpu_register_cmd(state, (struct GpuCmdInfo_t){.name="DrawLine", .id=EGPUCMD_DrawLine, .cmd=gpu_cmd_impl_DrawLine, .validator=validate_gpu_cmd_impl_DrawLine, .toString=toString_gpu_cmd_impl_DrawLine, .translate=translate_gpu_cmd_impl_DrawLine});
 
     // 3d extensions
     gpu_init_commands_3d(state);
@@ -8,11 +8,21 @@
 #define GPU_CMD_MAX_DATA_SZ 8192        // Max command data buffer size  (GpuCommandList_t alloc size)
 #define GPU_MAX_SHADER_CMD_ID 128       // Max dispatch/cmd id of draw command
 #define GPU_MAX_BUFFER_ID 256           // Max buffer ids
+#define GPU_PROFILE_MAX_CMD_ID 32       // Profiled cmd ids, std cmds only (user cmds not profiled)
+#define GPU_PROFILE_HIST_BINS 20        // log2 exec cycle bins, bin n counts [2^(n-1), 2^n) cycles, last bin collects the rest
 #define GPU_FLASH_BUFFER_PAGE_SIZE 4096 // Flash buffers are fixed to 4k pages
 #define GPU_FLASH_MAX_WRITE 1024        // Max flash writes per boot
 #define GPU_TILEMAP_TILE_SZ 16          // Fixed tilemap size
 #define GPU_TILE_MAX_FRAMES 2   //8           // Max number of frames in tilemap anims/overlays [change] from 8 -> 2 ram optim
 #define GPU_TILE_MAX_LAYERS 8           // Max tilemap layers
+#define GPU_TILEMAP_CACHE_CNT 4         // Tilemap chunks with resolved autotiles cached, least recently prepared evicted
+#define GPU_TILEMAP_CACHE_LAYERS 2      // Autotile layers cached per cell, later layers resolve per tile
+#define GPU_TILE_PHASE_MOD 840          // Cached anim phase modulus, lcm(1..8) so phase % tileFrameCnt is exact for up to 8 frames
+#define GPU_TILE_PHASE_CNT 2            // Seeds with cached anim phase tables, shared by DrawTileMap & DrawWater
+#define GPU_FLUID_CACHE_CNT 4           // Water chunks with cached fluid neighbourhood
+#define GPU_TILE_OPAQUE_SHEET_CNT 8     // Layer sheets ( texture & frame offset ) with cached opaque tile bits
+#define GPU_SCRATCH_DEFAULT_SZ 1024     // Per instance scratch arena for tile temporaries, reset every gpu_begin_frame
+#define GPU_MAX_INSTANCES 2             // Gpu instances eg. one per core, indexes per instance state
 
 // Rendering impl
 #define GPU_ATTR_ALPHA_MASK 0b00001111  // Alpha bits (16 shades)
@@ -99,6 +109,11 @@ enum EGPUCmd
     EGPUCMD_DrawWater,
     EGPUCMD_CreateLinkedTilemapBuffer,
     EGPUCMD_CompositeTile,
+    EGPUCMD_BlitRectAffine,
+    EGPUCMD_BlitTile,
+    EGPUCMD_DrawSpriteBatch,
+    EGPUCMD_CallCmdList,
+    EGPUCMD_DrawScrollLayer,
     // User cmds
     EGPUCMD_UserCmdBegin = 64,  // Start of user non-std cmds when registering custom gpu cmds
 };
@@ -112,6 +127,7 @@ enum ETextureFormat
     ETextureFormat_8BPP,            // 8 bits per pixel
     ETextureFormat_RGB16,           // 16BPP
     ETextureFormat_RGBA16,          // 16BPP + 8bit alpha
+    ETextureFormat_CmdList,         // Precompiled gpu cmds, run with GPUCMD_CallCmdList
 };
 
 
@@ -146,12 +162,17 @@ typedef struct __attribute__((__packed__)) ColRGBF_t
 } ColRGBF_t;
 
 
+/** Header cull rect x unit, fits FRAME_W in 8 bits */
+#define GPU_CMD_CULL_RECT_X_SCALE 2
+
+
 /** Gpu cmd flags
  */
 enum EGpuCmd_Header_Flags
 {
     EGpuCmd_Header_Flags_None,
     EGpuCmd_Header_Flags_TileCullMask = 1 << 0,
+    EGpuCmd_Header_Flags_CullRect = 1 << 1,        // cullMin/Max bounds valid
 };
 
 
@@ -162,6 +183,10 @@ typedef struct __attribute__((__packed__)) GpuCmd_Header
     uint16_t sz;            // size of command    
     uint8_t flags;          // command flags
     uint16_t cullTileMask;  // Per cmd tile cull
+    uint8_t cullMinX;       // Screen space bounds clamped to frame, x in GPU_CMD_CULL_RECT_X_SCALE units
+    uint8_t cullMaxX;       
+    uint8_t cullMinY;       
+    uint8_t cullMaxY;       
 } GpuCmd_Header;
 
 
@@ -432,6 +457,43 @@ typedef struct __attribute__((__packed__)) GPUCMD_BlitRect
 } GPUCMD_BlitRect;
 
 
+/** Sprite instance for GPUCMD_DrawSpriteBatch */
+typedef struct __attribute__((__packed__)) GpuSpriteInstance
+{
+    int16_t x;
+    int16_t y;
+    uint16_t srcX;
+    uint16_t srcY;
+    uint8_t w;
+    uint8_t h;
+    uint8_t flags;          // EDrawTextureFlags
+} GpuSpriteInstance;
+
+
+/** Draw many BlitRects sharing texture & blend state */
+typedef struct __attribute__((__packed__)) GPUCMD_DrawSpriteBatch
+{    
+    GpuCmd_Header header; 
+    uint8_t bufferId;       // Texture buffer
+    uint16_t colKey;        // Colkey for 16BPP modes, transparent index for palette modes
+    uint16_t palBufferId;   // Palette buffer id
+    uint8_t blendMode;
+    uint8_t writeAlpha;     // Write alpha
+    uint16_t instanceCnt;
+    GpuSpriteInstance instances[0];     // [must be last entry] instanceCnt sprites
+} GPUCMD_DrawSpriteBatch;
+
+
+/** Run precompiled cmds from ETextureFormat_CmdList buffer */
+typedef struct __attribute__((__packed__)) GPUCMD_CallCmdList
+{    
+    GpuCmd_Header header; 
+    uint16_t bufferId;      // Cmd list buffer
+    int16_t offsetX;        // Offset applied to cmds with a translate handler
+    int16_t offsetY;
+} GPUCMD_CallCmdList;
+
+
 /** Init renderer 3D */
 typedef struct __attribute__((__packed__)) GPUCMD_InitRenderer3D
 {    
@@ -503,48 +565,78 @@ typedef struct __attribute__((__packed__)) GPUCMD_DrawMesh3D
 } GPUCMD_DrawMesh3D;
 
 
-/** Tilemap data for GPUCMD_BlitTile*/
-typedef struct __attribute__((__packed__)) BlitTile
-{
-    GPUCMD_BlitRect blit; // tile blit info
-} BlitTile;
+#define BLIT_TILE_EMPTY 0xffff     // BlitTilemapData tile index skipped
 
 
-/** Tilemap data for GPUCMD_BlitTile, holds array of BlitTile to render to screen*/
+/** Tilemap data for GPUCMD_BlitTile, grid of atlas tile indices stored row first in a gpu buffer */
 typedef struct __attribute__((__packed__)) BlitTilemapData
 {
-    int16_t tileW;  // Tile size
-    int16_t tileH;
-    uint16_t tilesCnt;  // tiles count (dynamic cmd)
-    BlitTile tiles[0]; // tiles
+    uint16_t tileW;     // Tile size
+    uint16_t tileH;
+    uint16_t mapW;      // Grid size in tiles
+    uint16_t mapH;
+    uint16_t tiles[0];  // Atlas tile index ( mapW*mapH ), atlas tiles packed row first at tileW*tileH
 } BlitTilemapData;
 
 
-/** Blit tile */
+/** Blit tile grid from atlas in a single cmd */
 typedef struct __attribute__((__packed__)) GPUCMD_BlitTile
 {    
     GpuCmd_Header header; 
-    uint16_t textureBufferId;           // Tile texture buffer
-    uint16_t tileDataBufferId;          // Tile data buffer    
-    int16_t dstX;
+    uint16_t textureBufferId;           // Tile atlas texture buffer
+    uint16_t tileDataBufferId;          // BlitTilemapData buffer    
+    int16_t dstX;                       // Grid origin on screen
     int16_t dstY;
-    uint16_t w;
+    uint16_t w;                         // Dst clip size from origin
     uint16_t h;      
+    uint16_t colKey;                    // Colkey for 16BPP modes, transparent index for palette modes
+    uint16_t palBufferId;               // Palette buffer id for 8BPP atlas
+    uint8_t blendMode;                  // EBlendMode_None or EBlendMode_ColorKey
 } GPUCMD_BlitTile;
 
 
-/** Affine blitter */
+#define SCROLL_LAYER_NO_LINE_SCROLL 0xffff     // GPUCMD_DrawScrollLayer without per line offsets
+
+
+/** Wrapping tilemap background layer, BlitTilemapData grid repeats on both axes. Screen pixel (x,y) samples map pixel 
+ * (scrollX + x + lineScroll[y], scrollY + y), lineScroll is an optional int16 x offset per screen line for raster effects.
+*/
+typedef struct __attribute__((__packed__)) GPUCMD_DrawScrollLayer
+{    
+    GpuCmd_Header header; 
+    uint16_t textureBufferId;           // Tile atlas texture buffer
+    uint16_t tileDataBufferId;          // BlitTilemapData buffer    
+    uint16_t lineScrollBufferId;        // int16 x offset per screen line or SCROLL_LAYER_NO_LINE_SCROLL
+    int16_t scrollX;                    // Scroll registers, map pixel at screen origin
+    int16_t scrollY;
+    uint16_t y;                         // Screen rows covered by layer
+    uint16_t h;
+    uint16_t colKey;                    // Colkey for 16BPP modes, transparent index for palette modes
+    uint16_t palBufferId;               // Palette buffer id for 8BPP atlas
+    uint8_t blendMode;                  // EBlendMode_None or EBlendMode_ColorKey
+} GPUCMD_DrawScrollLayer;
+
+
+/** Affine blitter, xform maps dst pixel (x,y) relative to dstX/dstY to src texel in 16.16 fixed point
+ * u = xform[0]*x + xform[1]*y + xform[2], v = xform[3]*x + xform[4]*y + xform[5]. Dst pixels mapping outside src rect are skipped.
+*/
 typedef struct __attribute__((__packed__)) GPUCMD_BlitRectAffine
 {    
     GpuCmd_Header header; 
     uint16_t bufferId;          // Texture buffer id       
-    int16_t dstX;
+    uint16_t srcX;              // Src rect sampled
+    uint16_t srcY;
+    uint16_t srcW;
+    uint16_t srcH;
+    int16_t dstX;               // Dst bounds of transformed rect
     int16_t dstY;
-	uint8_t log_size; // always square
-	bool has_opacity_metadata;
-	bool hflip;
-	bool vflip;
-    affine_transform xform;
+    uint16_t dstW;
+    uint16_t dstH;
+    uint16_t colKey;            // Colkey for 16BPP modes, transparent index for palette modes
+    uint16_t palBufferId;       // Palette buffer id ( fill col for EBlendMode_FillMasked, tint for EBlendMode_ColorKeyTintAdd )
+    uint8_t blendMode;
+    uint8_t writeAlpha;         // Write alpha
+    affine_transform xform;     // dst -> src
 } GPUCMD_BlitRectAffine;
 
 
@@ -574,6 +666,21 @@ typedef struct TileFrameBuffer_t
 } TileFrameBuffer_t;
 
 
+/** Command index binned by tile, built once per command list so tile runs only visit 
+ * commands overlapping the tile.
+*/
+#define GPU_MAX_TILE_BINS 16     // One per cullTileMask bit
+typedef struct GpuTileBins_t
+{
+    uint16_t* cmdOffsets;                       // Command data offsets grouped by tile, list order kept per tile
+    uint32_t cmdOffsetsCapacity;                
+    uint16_t tileStart[GPU_MAX_TILE_BINS];      // First entry in cmdOffsets per tile
+    uint16_t tileCount[GPU_MAX_TILE_BINS];      // Entry count per tile
+    uint16_t cmdCount;                          // Commands in binned list
+    bool valid;                                 // Bins built, linear walk used otherwise
+} GpuTileBins_t;
+
+
 /** Gpu command access type */
 enum EGpuCmdListAccessType
 {
@@ -616,14 +723,24 @@ typedef struct __attribute__((__packed__)) GpuFrameStats_t
 } GpuFrameStats_t;
 
 
+/** Per cmd id exec profile */
+typedef struct __attribute__((__packed__)) GpuCmdProfile_t
+{
+    uint32_t execCnt;                           // Cmd exec count ( per tile slice )
+    uint32_t totalCycles;                       // Total exec cycles ( picocom_cycles_32 ticks )
+    uint32_t maxCycles;                         // Max exec cycles
+    uint16_t hist[GPU_PROFILE_HIST_BINS];       // log2 exec cycles histogram, saturates
+} GpuCmdProfile_t;
+
+
 /** Detailed frame profile data */
 typedef struct __attribute__((__packed__)) GpuFrameProfile
 {
     bool isValid;                   // Stats valid
     uint32_t cmdSeqNum;			
-    //uint32_t cmdExecCounts[GPU_MAX_SHADER_CMD_ID];   // Per command exec count    
-    //uint32_t cmdMaxTime[GPU_MAX_SHADER_CMD_ID];      // Max exec per cmd
     uint32_t frameCullCounts;                         // Total frame culled cmds    
+    uint32_t cyclesPerUs;                             // Cmd cycle tick rate of profiling vdp
+    GpuCmdProfile_t cmds[GPU_PROFILE_MAX_CMD_ID];     // Per cmd id exec stats
 } GpuFrameProfile;
 
 
@@ -641,6 +758,8 @@ typedef struct GpuBufferInfo
     uint32_t writeCnt;      // Writes to buffer
     uint32_t finalWriteCnt; // Writes to buffer
     bool locked;            // Lock for writing until buffer re-creatoin
+    uint16_t cmdListCnt;    // Cmds in valid cmd list
+    bool cmdListValid;      // Cmd list passed validation on last upload
 } GpuBufferInfo;
 
 
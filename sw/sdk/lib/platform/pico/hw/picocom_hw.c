@@ -5,6 +5,10 @@
 #include "picocom/devkit.h"
 #include "hardware/clocks.h"
 #include "pico/multicore.h"
+#include "hardware/structs/systick.h"
+
+// Fwd
+static Core1Callback_t g_core1Entry = 0;
 
 
 //
@@ -14,6 +18,8 @@ void picocom_hw_setup_clocks(PicocomInitOptions_t* options)
     if(options->clockSpeedKhz)
         set_sys_clock_khz(options->clockSpeedKhz, true);
 
+    picocom_cycles_init();
+
     // print init msg as soon as booted for debug
     stdio_init_all();
     printf("%s init\n", options->name);
@@ -88,6 +94,28 @@ uint64_t picocom_time_ms_64()
 }
 
 
+void picocom_cycles_init()
+{
+    // SysTick free running from processor clock, max 24bit reload
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;
+}
+
+
+uint32_t picocom_cycles_32()
+{
+    // SysTick counts down, invert to count up
+    return ~systick_hw->cvr & PICOCOM_CYCLES_MASK;
+}
+
+
+uint32_t picocom_cycles_per_us()
+{
+    return clock_get_hz(clk_sys) / 1000000;
+}
+
+
 void picocom_sleep_us(uint32_t time)
 {    
     sleep_us(time);
@@ -106,7 +134,16 @@ int picocom_message_box(const char* title, const char* msg)
     return 0;
 }
 
+static void picocom_core1_entry()
+{
+    // SysTick is per core
+    picocom_cycles_init();
+    g_core1Entry();
+}
+
+
 void picocom_multicore_launch_core1(Core1Callback_t entry)
 {
-    multicore_launch_core1(entry);
+    g_core1Entry = entry;
+    multicore_launch_core1(picocom_core1_entry);
 }
@@ -117,6 +117,7 @@ typedef struct __attribute__((__packed__)) VDP1CMD_AckDrawCmdData
     uint32_t gpuErrors;             // gpu error count
     uint32_t tileBusCopyTotalTime;  // stat for total copy time
     uint32_t tileRenderTotalTime;   // stat for tile render time 
+    uint32_t tileBusBytesSaved;     // stat for bytes saved by tile compression
 } VDP1CMD_AckDrawCmdData;
 
 
@@ -12,6 +12,7 @@
 #define GPU_MAX_BUFFER  128                                     // Max buffers gpu can store
 #define VDP2_TILE_RENDER_POOL_SZ 2                              // Tile render queue size
 #define VDP2_TILE_WRITER_QUEUE_SZ 2
+#define VDP2_BG_CMD_DATA_SZ 256                                 // Background layer cmd data held by vdp2
 #define TILE_CNT_Y (FRAME_H/VDP_TILEFRAME_BUFFER_Y_SIZE)        // Tile count split based on VDP2CMD_TileFrameBuffer transfer size (determins render size)
 
 
@@ -25,6 +26,9 @@ enum EBusCmd_VDP2
     EBusCmd_VDP2_TileFrameBuffer16bpp,    
     EBusCmd_VDP2_TileFrameBuffer8bpp,    
     EBusCmd_VDP2_DrawCmdData, // uses hw_vdp2_types.h
+    EBusCmd_VDP2_ReuseTile,
+    EBusCmd_VDP2_TileFrameBuffer16bppRLE,
+    EBusCmd_VDP2_BackgroundDrawCmdList,
 };
 
 
@@ -104,11 +108,60 @@ typedef struct __attribute__((__packed__)) VDP2CMD_TileFrameBuffer8bpp
 
 
 
-/** Background draw commands to composite with scanlines, must be submitted before effected scanline */
+/** Run length encoded tile frame buffer, same prefix as VDP2CMD_TileFrameBuffer16bpp. Followed by pixel data, 
+ * attr data, pixel & attr ctrl streams ( 4 byte aligned ), vdp2 cmds and VDP2TileRLETrailer at packet end. See tile_codec.h
+*/
+typedef struct __attribute__((__packed__)) VDP2CMD_TileFrameBuffer16bppRLE
+{   
+    Cmd_Header_t header;    
+    uint32_t cmdSeqNum;         // cmd seq num
+    uint32_t cmdFlags;          // Command flag eg. flip display    
+    uint16_t tileId;            // tile id    
+    uint16_t pixels[];          // encoded pixel data
+} VDP2CMD_TileFrameBuffer16bppRLE;
+
+
+/** Rle tile trailer, last bytes of VDP2CMD_TileFrameBuffer16bppRLE packet */
+typedef struct __attribute__((__packed__)) VDP2TileRLETrailer
+{   
+    uint32_t passId;            // Padd index
+    uint32_t vdp2CmdDataSz;     // Size of cmd data
+    uint16_t vdp2CmdDataCount;  // Command cnt
+    uint16_t pixelCtrlCnt;      // Pixel run/literal ctrl cnt
+    uint16_t pixelDataCnt;      // Encoded pixel count
+    uint16_t attrCtrlCnt;       // Attr run/literal ctrl cnt
+    uint16_t attrDataCnt;       // Encoded attr byte count
+    uint8_t defaultBlendMode;   // Zero pipeline default comp blend
+    uint8_t flags;              // TILE_CODEC_FLAG_*
+} VDP2TileRLETrailer;
+
+
+/** Reuse tile, tile cmds unchanged since last frame so previous frame pixels are kept instead of sending tile */
+typedef struct __attribute__((__packed__)) VDP2CMD_ReuseTile
+{   
+    Cmd_Header_t header;    
+    uint32_t cmdSeqNum;         // cmd seq num
+    uint32_t cmdFlags;          // Command flag eg. flip display    
+    uint16_t tileId;            // tile id    
+} VDP2CMD_ReuseTile;
+
+
+/** Background layers held by vdp2, cmds run into each tile under the vdp1 tile on pass zero ( eg. GPUCMD_DrawScrollLayer ).
+ * Latched at the start of the next frame so scroll registers never change mid frame, zero drawCmdCnt disables the background.
+ * Sent via vdp1 forwarding, vdp1 replies with the same cmd once written to vdp2.
+*/
 typedef struct __attribute__((__packed__)) VDP2CMD_BackgroundDrawCmdList
 {       
     Cmd_Header_t header;    
-    uint32_t frameId;       // Link frame ID to scanline compositor, discarded if older than current frame
-    uint16_t drawCmdCnt;    // drawCommands[] count
-    VDP1CMD_DrawCmdData* drawCommands; 
+    uint16_t drawCmdCnt;                        // Cmd cnt in drawCmdData
+    uint32_t drawCmdDataSz;                     // Size of cmd data
+    uint8_t drawCmdData[VDP2_BG_CMD_DATA_SZ];   // Gpu cmds
 } VDP2CMD_BackgroundDrawCmdList;
+
+
+/** Forward ack for VDP2CMD_BackgroundDrawCmdList */
+typedef struct __attribute__((__packed__)) VDP2CMD_BackgroundDrawCmdListAck
+{       
+    Cmd_Header_t header;    
+    uint16_t drawCmdCnt;        // Cmd cnt forwarded
+} VDP2CMD_BackgroundDrawCmdListAck;
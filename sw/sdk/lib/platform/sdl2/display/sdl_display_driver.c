@@ -116,6 +116,16 @@ uint16_t* get_display_buffer()
     return screenBuffer;
 }
 
+uint16_t* get_display_front_buffer()
+{
+    if(!sdlDisplayState)
+        return 0;
+
+    int index = (sdlDisplayState->currentBufferId + 1) % 2;
+    uint16_t* screenBuffer = sdlDisplayState->screenBuffers[index];
+    return screenBuffer;
+}
+
 void display_buffer_copy_front()
 {
     if(!sdlDisplayState)
@@ -138,10 +148,7 @@ void display_buffer_copy_front()
         for(int j=0;j<sdlSimWindowScale;j++)    // line repeat 
             for(int x=0;x<FRAME_W;x++)
             {
-                struct ColRGBF_t rgbf = gpu_col_to_rgbf(gpu_col_from_uint16(screenBuffer[x + (y*FRAME_W)]));            
-                uint32_t c = (((uint8_t)(rgbf.r * 255) & 0xff) << 16)
-                    | (((uint8_t)(rgbf.g * 255) & 0xff) << 8)
-                    | (((uint8_t)(rgbf.b * 255) & 0xff) << 0);
+                uint32_t c = gpu_col_to_rgb888_uint16(screenBuffer[x + (y*FRAME_W)]);
 
                 int dstIndex = 0;
 
@@ -179,10 +186,13 @@ void display_buffer_copy_front()
 }
 
 
-uint16_t* flip_display_blocking()
+bool flip_display_async()
 {
     if(!sdlDisplayState)
-        return 0;
+        return false;
+
+    if(!flip_display_poll())
+        return false;
     
     // get back
     int index = (sdlDisplayState->currentBufferId + 0) % 2;
@@ -194,7 +204,7 @@ uint16_t* flip_display_blocking()
     // get screen FB
     uint32_t* dstFb = (uint32_t*) sdlDisplayState->screenSurface->pixels;
     if(!dstFb){		
-        return 0;
+        return false;
     }
 
     // Upscale in an absolute horible way
@@ -204,10 +214,7 @@ uint16_t* flip_display_blocking()
         for(int j=0;j<sdlSimWindowScale;j++)    // line repeat 
             for(int x=0;x<FRAME_W;x++)
             {
-                struct ColRGBF_t rgbf = gpu_col_to_rgbf(gpu_col_from_uint16(screenBuffer[x + (y*FRAME_W)]));            
-                uint32_t c = (((uint8_t)(rgbf.r * 255) & 0xff) << 16)
-                    | (((uint8_t)(rgbf.g * 255) & 0xff) << 8)
-                    | (((uint8_t)(rgbf.b * 255) & 0xff) << 0);
+                uint32_t c = gpu_col_to_rgb888_uint16(screenBuffer[x + (y*FRAME_W)]);
 
                 int dstIndex = 0;
 
@@ -219,7 +226,7 @@ uint16_t* flip_display_blocking()
     // Copy small fb to desktop window, size to fit
     SDL_Surface* screen = SDL_GetWindowSurface(sdlDisplayState->window);
     if (!screen) {		
-        return 0;
+        return false;
     }
 
     struct SDL_Rect destRect = (struct SDL_Rect){.x = 0, 
@@ -254,10 +261,46 @@ uint16_t* flip_display_blocking()
         remain = sdlDisplayState->frameTime;
     
     // Free fps on native, sdl sim will lock fps
+    sdlDisplayState->flipReadyTime = sdlDisplayState->lastFlipTime;
 #ifndef PICOCOM_NATIVE_SIM    
     if(sdlSimulateFpsLimit && remain > 0)
-        picocom_sleep_us(remain);
+        sdlDisplayState->flipReadyTime += remain;
 #endif        
+    sdlDisplayState->flipPending = true;
+    
+    return true;
+}
+
+
+bool flip_display_poll()
+{
+    if(!sdlDisplayState || !sdlDisplayState->flipPending)
+        return true;
+
+    if((int32_t)(picocom_time_us_32() - sdlDisplayState->flipReadyTime) < 0)
+        return false;
+
+    sdlDisplayState->flipPending = false;
+    return true;
+}
+
+
+uint16_t* flip_display_blocking()
+{
+    if(!sdlDisplayState)
+        return 0;
+
+    // wait prev async flip
+    while(!flip_display_poll())
+        picocom_sleep_us(100);
+
+    if(!flip_display_async())
+        return 0;
+
+    // wait sim vsync
+    int32_t remain = (int32_t)(sdlDisplayState->flipReadyTime - picocom_time_us_32());
+    if(remain > 0)
+        picocom_sleep_us(remain);
     
     // get current / new
     return get_display_buffer();    
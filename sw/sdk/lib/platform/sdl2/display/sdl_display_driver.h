@@ -30,6 +30,8 @@ typedef struct SDLDisplayDriverState_t
 
     uint32_t frameTime;
     uint32_t lastFlipTime;
+    uint32_t flipReadyTime;             // simulated vsync, async flip completes after
+    bool flipPending;
 
 } SDLDisplayDriverState_t;
 
@@ -82,6 +82,7 @@ void test_core_vdp1()
     vdpOptions.vdp2CmdFwdWriteBufferSz = 0;
     vdpOptions.gpuOptions.bufferRamSz = VDP1_GPU_RAM_SZ;
     vdpOptions.gpuOptions.enableFlash = true;
+    vdpOptions.gpuOptions.enableTilemapCaches = true;
 
     // init vdp core
     int res;
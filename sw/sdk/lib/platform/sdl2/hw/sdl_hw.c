@@ -1,6 +1,7 @@
 #include "platform/sdl2/sdl_platform.h"
 #include "picocom/devkit.h"
 #include <pthread.h>
+#include <time.h>
 
 
 // Globals
@@ -56,6 +57,27 @@ uint64_t picocom_time_us_64()
 }
 
 
+void picocom_cycles_init()
+{
+    // monotonic clock always running
+}
+
+
+uint32_t picocom_cycles_32()
+{
+    // ns ticks, SDL_GetTicks is ms only
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+
+uint32_t picocom_cycles_per_us()
+{
+    return 1000;
+}
+
+
 int picocom_message_box(const char* title, const char* msg)
 {    
 	const SDL_MessageBoxButtonData buttons[] = {
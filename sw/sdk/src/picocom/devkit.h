@@ -76,9 +76,21 @@ uint32_t picocom_time_us_32();          // Get current time in uS
 uint32_t picocom_time_ms_32();          // Get current time in ms
 uint64_t picocom_time_us_64();          // Get current time in uS
 uint64_t picocom_time_ms_64();          // Get current time in ms
+void picocom_cycles_init();             // Start cycle counter on calling core ( per core on pico, core1 started by picocom_multicore_launch_core1 )
+uint32_t picocom_cycles_32();           // Cheap free running cycle counter for short spans, wraps at PICOCOM_CYCLES_MASK
+uint32_t picocom_cycles_per_us();       // picocom_cycles_32 ticks per uS
 typedef void (*Core1Callback_t)(void);
 void picocom_multicore_launch_core1(Core1Callback_t entry);
 
+// cycle counter width, 24bit SysTick on pico, ns clock in sims
+// NOTE: SysTick wraps every 2^24 cycles ( ~110ms at 150MHz ), time longer spans with picocom_time_us_32
+#ifdef PICOCOM_SDL
+#define PICOCOM_CYCLES_MASK 0xffffffff
+#else
+#define PICOCOM_CYCLES_MASK 0x00ffffff
+#endif
+#define picocom_cycles_diff(start, end) (((end) - (start)) & PICOCOM_CYCLES_MASK)
+
 // misc
 bool stdio_init_all();
 
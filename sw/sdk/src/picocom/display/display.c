@@ -24,7 +24,8 @@ struct DisplayOptions_t display_default_options()
 {
     struct DisplayOptions_t options = {
         .maxPacketSize = DISPLAY_GPU_CMD_BUS_MAX_PACKET_SZ,
-        .cmdListAllocSize = DISPLAY_GPU_CMD_ALLOC_SZ
+        .cmdListAllocSize = DISPLAY_GPU_CMD_ALLOC_SZ,
+        .cmdOverflowBinAllocSize = DISPLAY_GPU_CMD_OVERFLOW_BIN_SZ
     };
     return options;
 }
@@ -79,6 +80,7 @@ int display_init_with_options(struct DisplayOptions_t* options)
     vdpOptions.vdp1Link_rx = vdp1Link_rx;        
     vdpOptions.cmdListPoolCnt = 2;          // number of cmd lists to allow in flight
     vdpOptions.cmdListAllocSize = options->cmdListAllocSize;   // cmd list size sould match max bus packet
+    vdpOptions.overflowBinAllocSize = options->cmdOverflowBinAllocSize;
     
     g_DisplayState->client = vdp1_client_init(&vdpOptions);
     if(!g_DisplayState->client)
@@ -707,6 +709,7 @@ int display_set_profiler_enabled(bool enabled, uint32_t level)
         return res;
     }
 
+    g_DisplayState->profilerEnabled = enabled;
     return SDKErr_OK;
 }
 
@@ -723,17 +726,16 @@ DisplayStats_t* display_stats()
 
 static void display_print_vdp_frame_profile(GpuFrameProfile* stats)
 {    
-    /*const char* indent= "\t\t";
+    const char* indent= "\t\t";
     if(!stats->isValid)
         return;
     printf("%sframeId: %d, frameCullCounts: %d\n", indent, stats->cmdSeqNum, stats->frameCullCounts);    
-    for(int i=0;i<GPU_MAX_SHADER_CMD_ID;i++)
+    for(int i=0;i<GPU_PROFILE_MAX_CMD_ID;i++)
     {
-        if(stats->cmdExecCounts[i] == 0)
+        const GpuCmdProfile_t* cmdProfile = &stats->cmds[i];
+        if(cmdProfile->execCnt == 0)
             continue;
         
-        const char* cmdName = 0;
-        
         printf("%s\t" "cmd[", indent);
         if(g_DisplayState->gpuState && g_DisplayState->gpuState->cmdInfos[i].name )
         {
@@ -743,8 +745,20 @@ static void display_print_vdp_frame_profile(GpuFrameProfile* stats)
         {
             printf("%d", i);
         }
-        printf("] cnt:%d, max:%duS\n", stats->cmdExecCounts[i], stats->cmdMaxTime[i]);
-    }*/
+        uint32_t cyclesPerUs = stats->cyclesPerUs ? stats->cyclesPerUs : 1;
+        printf("] cnt:%d, total:%duS, avg:%dns, max:%dns\n", cmdProfile->execCnt, cmdProfile->totalCycles / cyclesPerUs, 
+            (int)(((uint64_t)cmdProfile->totalCycles * 1000) / ((uint64_t)cmdProfile->execCnt * cyclesPerUs)), 
+            (int)(((uint64_t)cmdProfile->maxCycles * 1000) / cyclesPerUs));
+
+        // log2 histogram, bins labeled by min cycles
+        printf("%s\t\t" "hist(cycles)", indent);
+        for(int j=0;j<GPU_PROFILE_HIST_BINS;j++)
+        {
+            if(cmdProfile->hist[j])
+                printf(" %d%s:%d", j ? 1 << (j-1) : 0, j == GPU_PROFILE_HIST_BINS-1 ? "+" : "", cmdProfile->hist[j]);
+        }
+        printf("\n");
+    }
 }
 
 
@@ -779,6 +793,16 @@ void display_print_stats()
 
     printf("Frame[%d] stats fps: %f, lastT: %duS, minT: %duS, maxT: %duS\n", stats->frameId, stats->avgFps, stats->lastFrameTime, stats->minFrameTime, stats->maxFrameTime);
     printf("\tstats lastCmdSubmitSz: %d, lastCmdSubmitPacketCnt: %d, lastCmdSubmitCnt: %d\n", stats->lastCmdSubmitSz, stats->lastCmdSubmitPacketCnt, stats->lastCmdSubmitCnt);
+    if(g_DisplayState && g_DisplayState->client)
+        printf("\tstats tileBusCopyTotalTime: %duS, tileRenderTotalTime: %duS, tileBusBytesSaved: %d\n", g_DisplayState->client->tileBusCopyTotalTime, g_DisplayState->client->tileRenderTotalTime, g_DisplayState->client->tileBusBytesSaved);
+
+    // fetch last complete vdp1 frame profile
+    if(g_DisplayState && g_DisplayState->client && g_DisplayState->profilerEnabled)
+    {
+        static struct VDP1CMD_GpuFrameProfile profile;
+        if(vdp1_client_get_frame_profile(g_DisplayState->client, &profile) == SDKErr_OK)
+            stats->gpuFrameProfile[0] = profile.frameProfile;
+    }
     for(int i=0;i<2;i++)
     {
         if(stats->gpuFrameStats[i].isValid)
@@ -16,6 +16,7 @@ extern "C" {
 #define FRAME_TILE_CNT_Y (FRAME_H/FRAME_TILE_SZ_Y)  // Tile count split based on VDP2CMD_TileFrameBuffer transfer size (determins render size)
 #define DISPLAY_GPU_CMD_BUS_MAX_PACKET_SZ   1024*8    // max size of command list packet
 #define DISPLAY_GPU_CMD_ALLOC_SZ   			1024*8	// cmd buffer allocation size
+#define DISPLAY_GPU_CMD_OVERFLOW_BIN_SZ		0		// overflow cmds binned by tile band ( 0 disabled, re-renders in passes. must be >= 2x cmd alloc size )
 #define VDP1_GPU_RAM_SZ   					1024*64	// gpu buffer ram allocated to VDP1
 #define VDP2_GPU_RAM_SZ   					1024*64	// gpu buffer ram allocated to VDP2
 #define Display_Impl_State_MaxFrameTimeSamples 8	// FPS sampler
@@ -39,6 +40,7 @@ typedef struct DisplayOptions_t
 {
 	uint32_t maxPacketSize;						// Max packet size on VDP1 rx receiver.
 	uint32_t cmdListAllocSize;					// Total size of cmd buffer per submission ( must be < bus rx size on vdp )		
+	uint32_t cmdOverflowBinAllocSize;			// Overflow cmd buffer, cmds sent per tile band instead of full frame passes
 } DisplayOptions_t;
 
 
@@ -71,6 +73,7 @@ typedef struct DisplayState_t
 	struct VdpClientImpl_t* client;	// vdp client instance
 	struct DisplayStats_t stats;
 	struct GpuState_t* gpuState;      // optional gpu state for debug trace	
+	bool profilerEnabled;				// vdp1 profiler on, display_print_stats fetches frame profile
 	uint32_t frameStartTime;
 	uint32_t frameTimeIndex;
 	uint32_t frameTimes[Display_Impl_State_MaxFrameTimeSamples];     // fps sampler
@@ -129,8 +132,11 @@ extern uint16_t debugColors[3];
 bool display_driver_init(); 					// init display
 void display_driver_deinit(); 					// deinit display
 uint16_t* get_display_buffer(); 				// get working back buffer
+uint16_t* get_display_front_buffer(); 			// get displayed front buffer ( previous frame after flip )
 void display_buffer_copy_front(); 				// copy current back buffer to front
 uint16_t* flip_display_blocking(); 				// flip display & wait for next back buffer
+bool flip_display_async(); 						// request flip, false if flip still pending. Back buffer invalid until flip_display_poll() completes
+bool flip_display_poll(); 						// true when no flip pending & back buffer writable
 
 // Display api
 struct DisplayOptions_t display_default_options();// Get display default options
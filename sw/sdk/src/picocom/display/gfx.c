@@ -354,6 +354,7 @@ int gfx_fill_rect(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t col, ui
     fillCmd->h = h;
     fillCmd->header.cullTileMask = gpu_calc_tile_cull_mask(y, h);
     fillCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+    gpu_set_cmd_cull_rect(&fillCmd->header, x, y, w, h);
     fillCmd->blendMode = EBlendMode_None;
 
     return SDKErr_OK;
@@ -379,6 +380,7 @@ int gfx_fill_rect_blended(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t
     fillCmd->h = h;
     fillCmd->header.cullTileMask = gpu_calc_tile_cull_mask(y, h);
     fillCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+    gpu_set_cmd_cull_rect(&fillCmd->header, x, y, w, h);
     fillCmd->blendMode = blendMode;
 
     return SDKErr_OK;
@@ -592,6 +594,7 @@ int gfx_draw_text(uint32_t fontResourceId, uint32_t fontTextureBufferId, int16_t
         fillCmd->a = GPU_ATTR_ALPHA_MASK;
         fillCmd->writeAlpha = GPU_ATTR_ALPHA_MASK;
         fillCmd->blendMode = EBlendMode_FillMasked;
+        gpu_set_cmd_cull_rect(&fillCmd->header, fillCmd->dstX, fillCmd->dstY, fillCmd->w, fillCmd->h);
 
         curx += g->advance;
         curchar++;
@@ -753,6 +756,7 @@ int gfx_draw_texture(uint32_t texturebufferId, int16_t x, int16_t y, uint16_t sr
     // enable tile culling
     fillCmd->header.cullTileMask = gpu_calc_tile_cull_mask(fillCmd->dstY, fillCmd->h);    
     fillCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+    gpu_set_cmd_cull_rect(&fillCmd->header, fillCmd->dstX, fillCmd->dstY, fillCmd->w, fillCmd->h);
 
     return SDKErr_OK;    
 }
@@ -786,6 +790,7 @@ int gfx_draw_texture_blendmode(uint32_t texturebufferId, int16_t x, int16_t y, u
     // enable tile culling
     fillCmd->header.cullTileMask = gpu_calc_tile_cull_mask(fillCmd->dstY, fillCmd->h);    
     fillCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+    gpu_set_cmd_cull_rect(&fillCmd->header, fillCmd->dstX, fillCmd->dstY, fillCmd->w, fillCmd->h);
 
     return SDKErr_OK;  
 }
@@ -820,6 +825,191 @@ int gfx_draw_texture_blendmode_ex(uint32_t texturebufferId, int16_t x, int16_t y
     // enable tile culling
     fillCmd->header.cullTileMask = gpu_calc_tile_cull_mask(fillCmd->dstY, fillCmd->h);    
     fillCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+    gpu_set_cmd_cull_rect(&fillCmd->header, fillCmd->dstX, fillCmd->dstY, fillCmd->w, fillCmd->h);
+
+    return SDKErr_OK;  
+}
+
+
+int gfx_draw_texture_affine(uint32_t texturebufferId, int16_t x, int16_t y, uint16_t srcX, uint16_t srcY, uint16_t srcW, uint16_t srcH, float angle, float scaleX, float scaleY, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId)
+{
+    struct VdpClientImpl_t* client = display_get_impl();
+    if(!g_Gfx || !client)
+        return SDKErr_Fail;
+
+    if(scaleX == 0.0f || scaleY == 0.0f)
+        return SDKErr_OK;
+
+    struct GPUCMD_BlitRectAffine* fillCmd = (GPUCMD_BlitRectAffine*)gfx_alloc_raw(sizeof(GPUCMD_BlitRectAffine));
+    if(!fillCmd)
+        return SDKErr_Fail;
+
+    // dst bounds of rotated rect
+    float c = cosf(angle);
+    float s = sinf(angle);
+    float hw = srcW * fabsf(scaleX) * 0.5f;
+    float hh = srcH * fabsf(scaleY) * 0.5f;
+    float ex = (fabsf(c) * hw) + (fabsf(s) * hh);
+    float ey = (fabsf(s) * hw) + (fabsf(c) * hh);
+    int32_t x0 = (int32_t)floorf(x - ex);
+    int32_t y0 = (int32_t)floorf(y - ey);
+    int32_t x1 = (int32_t)ceilf(x + ex);
+    int32_t y1 = (int32_t)ceilf(y + ey);
+
+    GPU_INIT_CMD(fillCmd, EGPUCMD_BlitRectAffine);
+    fillCmd->bufferId = texturebufferId;
+    fillCmd->srcX = srcX;
+    fillCmd->srcY = srcY;
+    fillCmd->srcW = srcW;
+    fillCmd->srcH = srcH;
+    fillCmd->dstX = x0;
+    fillCmd->dstY = y0;
+    fillCmd->dstW = x1 - x0;
+    fillCmd->dstH = y1 - y0;
+    fillCmd->colKey = colKeyOrPal;
+    fillCmd->palBufferId = palBufferId;
+    fillCmd->blendMode = blendMode;
+    fillCmd->writeAlpha = GPU_ATTR_ALPHA_MASK;
+
+    // inverse xform, dst pixel center -> src texel, 16.16 fixed
+    float ux = c / scaleX;
+    float uy = s / scaleX;
+    float vx = -s / scaleY;
+    float vy = c / scaleY;
+    float dx = (x0 + 0.5f) - x;
+    float dy = (y0 + 0.5f) - y;
+    int32_t xform[6] = {
+        (int32_t)(ux * 65536.0f),
+        (int32_t)(uy * 65536.0f),
+        (int32_t)(((ux * dx) + (uy * dy) + (srcW * 0.5f)) * 65536.0f),
+        (int32_t)(vx * 65536.0f),
+        (int32_t)(vy * 65536.0f),
+        (int32_t)(((vx * dx) + (vy * dy) + (srcH * 0.5f)) * 65536.0f),
+    };
+    memcpy(fillCmd->xform, xform, sizeof(xform));
+
+    // enable tile culling
+    fillCmd->header.cullTileMask = gpu_calc_tile_cull_mask(fillCmd->dstY, fillCmd->dstH);    
+    fillCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+    gpu_set_cmd_cull_rect(&fillCmd->header, fillCmd->dstX, fillCmd->dstY, fillCmd->dstW, fillCmd->dstH);
+
+    return SDKErr_OK;  
+}
+
+
+int gfx_draw_tile_grid(uint32_t atlasBufferId, uint32_t tileDataBufferId, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId)
+{
+    struct VdpClientImpl_t* client = display_get_impl();
+    if(!g_Gfx || !client)
+        return SDKErr_Fail;
+
+    struct GPUCMD_BlitTile* fillCmd = (GPUCMD_BlitTile*)gfx_alloc_raw(sizeof(GPUCMD_BlitTile));
+    if(!fillCmd)
+        return SDKErr_Fail;
+
+    GPU_INIT_CMD(fillCmd, EGPUCMD_BlitTile);
+    fillCmd->textureBufferId = atlasBufferId;
+    fillCmd->tileDataBufferId = tileDataBufferId;
+    fillCmd->dstX = x;
+    fillCmd->dstY = y;
+    fillCmd->w = w;
+    fillCmd->h = h;
+    fillCmd->colKey = colKeyOrPal;
+    fillCmd->palBufferId = palBufferId;
+    fillCmd->blendMode = blendMode;
+
+    // enable tile culling
+    fillCmd->header.cullTileMask = gpu_calc_tile_cull_mask(fillCmd->dstY, fillCmd->h);    
+    fillCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+    gpu_set_cmd_cull_rect(&fillCmd->header, fillCmd->dstX, fillCmd->dstY, fillCmd->w, fillCmd->h);
+
+    return SDKErr_OK;  
+}
+
+
+int gfx_draw_scroll_layer(uint32_t atlasBufferId, uint32_t tileDataBufferId, int16_t scrollX, int16_t scrollY, uint16_t y, uint16_t h, uint16_t lineScrollBufferId, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId)
+{
+    struct VdpClientImpl_t* client = display_get_impl();
+    if(!g_Gfx || !client)
+        return SDKErr_Fail;
+
+    struct GPUCMD_DrawScrollLayer* layerCmd = (GPUCMD_DrawScrollLayer*)gfx_alloc_raw(sizeof(GPUCMD_DrawScrollLayer));
+    if(!layerCmd)
+        return SDKErr_Fail;
+
+    GPU_INIT_CMD(layerCmd, EGPUCMD_DrawScrollLayer);
+    layerCmd->textureBufferId = atlasBufferId;
+    layerCmd->tileDataBufferId = tileDataBufferId;
+    layerCmd->lineScrollBufferId = lineScrollBufferId;
+    layerCmd->scrollX = scrollX;
+    layerCmd->scrollY = scrollY;
+    layerCmd->y = y;
+    layerCmd->h = h;
+    layerCmd->colKey = colKeyOrPal;
+    layerCmd->palBufferId = palBufferId;
+    layerCmd->blendMode = blendMode;
+
+    // full width rows, cull by tile only
+    layerCmd->header.cullTileMask = gpu_calc_tile_cull_mask(y, h);    
+    layerCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+
+    return SDKErr_OK;  
+}
+
+
+int gfx_draw_sprite_batch(uint32_t textureBufferId, const GpuSpriteInstance* instances, uint32_t cnt, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId)
+{
+    struct VdpClientImpl_t* client = display_get_impl();
+    if(!g_Gfx || !client || (!instances && cnt))
+        return SDKErr_Fail;
+
+    // max sprites per cmd
+    uint32_t maxBatchCnt = (client->maxCmdSize - sizeof(GPUCMD_DrawSpriteBatch)) / sizeof(GpuSpriteInstance);
+    if(maxBatchCnt > 0xffff)
+        maxBatchCnt = 0xffff;
+    if(!maxBatchCnt)
+        return SDKErr_Fail;
+
+    while(cnt)
+    {
+        uint32_t batchCnt = cnt < maxBatchCnt ? cnt : maxBatchCnt;
+        uint32_t dataSz = batchCnt * sizeof(GpuSpriteInstance);
+
+        struct GPUCMD_DrawSpriteBatch* batchCmd = (GPUCMD_DrawSpriteBatch*)gfx_alloc_raw(sizeof(GPUCMD_DrawSpriteBatch) + dataSz);
+        if(!batchCmd)
+            return SDKErr_Fail;
+
+        GPU_INIT_CMD(batchCmd, EGPUCMD_DrawSpriteBatch);
+        batchCmd->header.sz += dataSz;
+        batchCmd->bufferId = textureBufferId;
+        batchCmd->colKey = colKeyOrPal;
+        batchCmd->palBufferId = palBufferId;
+        batchCmd->blendMode = blendMode;
+        batchCmd->writeAlpha = GPU_ATTR_ALPHA_MASK;
+        batchCmd->instanceCnt = batchCnt;
+        memcpy(batchCmd->instances, instances, dataSz);
+
+        // combined tile cull mask & bounds of all sprites in batch
+        uint16_t cullTileMask = 0;
+        int32_t minX = INT16_MAX, minY = INT16_MAX, maxX = INT16_MIN, maxY = INT16_MIN;
+        for(uint32_t i=0;i<batchCnt;i++)
+        {
+            const GpuSpriteInstance* sprite = &instances[i];
+            cullTileMask |= gpu_calc_tile_cull_mask(sprite->y, sprite->h);
+            if(sprite->x < minX) minX = sprite->x;
+            if(sprite->y < minY) minY = sprite->y;
+            if(sprite->x + sprite->w > maxX) maxX = sprite->x + sprite->w;
+            if(sprite->y + sprite->h > maxY) maxY = sprite->y + sprite->h;
+        }
+
+        // enable tile culling
+        batchCmd->header.cullTileMask = cullTileMask;
+        batchCmd->header.flags |= EGpuCmd_Header_Flags_TileCullMask;
+        gpu_set_cmd_cull_rect(&batchCmd->header, minX, minY, maxX - minX, maxY - minY);
+
+        instances += batchCnt;
+        cnt -= batchCnt;
+    }
 
     return SDKErr_OK;  
 }
@@ -1036,16 +1226,87 @@ int gfx_composite(uint8_t blendMode)
 }
 
 
+int gfx_set_vdp2_background(const struct GpuCommandList_t* list)
+{
+    struct VdpClientImpl_t* client = display_get_impl();
+    if(!g_Gfx || !client || g_Gfx->recordCmdList)
+        return SDKErr_Fail;
+
+    return vdp1_client_set_vdp2_background(client, list);
+}
+
+
 struct GpuCmd_Header* gfx_alloc_raw(uint32_t sz)
 {
     struct VdpClientImpl_t* client = display_get_impl();        
     if(!g_Gfx || !client)
         return 0;
 
+    if(g_Gfx->recordCmdList)
+        return gpu_cmd_list_add_next(g_Gfx->recordCmdList, sz);
+
     return vdp1_cmd_add_next(client, g_Gfx->currentVdpId, sz);
 }
 
 
+int gfx_begin_cmd_list(struct GpuCommandList_t* list)
+{
+    if(!g_Gfx || !list || g_Gfx->recordCmdList)
+        return SDKErr_Fail;
+
+    gpu_cmd_list_clear(list);
+    g_Gfx->recordCmdList = list;
+    return SDKErr_OK;
+}
+
+
+int gfx_end_cmd_list()
+{
+    if(!g_Gfx || !g_Gfx->recordCmdList)
+        return SDKErr_Fail;
+
+    g_Gfx->recordCmdList = 0;
+    return SDKErr_OK;
+}
+
+
+int gfx_upload_cmd_list(const struct GpuCommandList_t* list, uint8_t arenaId)
+{
+    if(!g_Gfx || !list || list->offset <= list->headerSz)
+        return SDKErr_Fail;
+
+    // cmds packed back to back as a single byte row, vdp1 validates on first call
+    uint32_t sz = list->offset - list->headerSz;
+    if(sz > 0xffff)
+        return SDKErr_Fail;
+
+    uint32_t bufferId = gfx_upload_buffer(EGfxTargetVDP1, arenaId, list->cmdData + list->headerSz, sz, ETextureFormat_CmdList, sz, 1);
+    if(bufferId == 0 || bufferId == -1)
+        return SDKErr_Fail;
+    return bufferId;
+}
+
+
+int gfx_call_cmd_list(uint32_t cmdListBufferId, int16_t offsetX, int16_t offsetY)
+{
+    struct VdpClientImpl_t* client = display_get_impl();
+    if(!g_Gfx || !client || g_Gfx->recordCmdList)
+        return SDKErr_Fail;
+
+    struct GPUCMD_CallCmdList* callCmd = (GPUCMD_CallCmdList*)gfx_alloc_raw(sizeof(GPUCMD_CallCmdList));
+    if(!callCmd)
+        return SDKErr_Fail;
+
+    // list bounds unknown client side, runs on all tiles & nested cmds cull themselves
+    GPU_INIT_CMD(callCmd, EGPUCMD_CallCmdList);
+    callCmd->bufferId = cmdListBufferId;
+    callCmd->offsetX = offsetX;
+    callCmd->offsetY = offsetY;
+
+    return SDKErr_OK;  
+}
+
+
 int gfx_set_vdp(enum EGfxTargetVDP vdpId)
 {
     struct VdpClientImpl_t* client = display_get_impl();        
@@ -256,6 +256,7 @@ typedef struct Gfx_impl
     uint8_t currentVdpId;           // Target vdp    
     uint8_t inFrame;    
     uint32_t triCnt;
+    struct GpuCommandList_t* recordCmdList;  // Cmd list being recorded, gfx_alloc_raw appends here when set
 } Gfx_impl;
 
 
@@ -305,6 +306,10 @@ int gfx_get_text_size(uint32_t fontResourceId, uint32_t fontTextureBufferId, con
 int gfx_draw_texture(uint32_t texturebufferId, int16_t x, int16_t y, uint16_t srcX, uint16_t srcY, uint16_t srcW, uint16_t srcH, uint16_t colKeyOrPal, uint8_t flags); // Draw texture to screen
 int gfx_draw_texture_blendmode(uint32_t texturebufferId, int16_t x, int16_t y, uint16_t srcX, uint16_t srcY, uint16_t srcW, uint16_t srcH, uint16_t colKeyOrPal, uint8_t flags, uint8_t blendMode); // Draw texture to screen
 int gfx_draw_texture_blendmode_ex(uint32_t texturebufferId, int16_t x, int16_t y, uint16_t srcX, uint16_t srcY, uint16_t srcW, uint16_t srcH, uint16_t colKeyOrPal, uint8_t flags, uint8_t blendMode, uint16_t palBufferId);
+int gfx_draw_texture_affine(uint32_t texturebufferId, int16_t x, int16_t y, uint16_t srcX, uint16_t srcY, uint16_t srcW, uint16_t srcH, float angle, float scaleX, float scaleY, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId); // Draw texture rotated (radians) & scaled about its center at x,y
+int gfx_draw_tile_grid(uint32_t atlasBufferId, uint32_t tileDataBufferId, int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId); // Draw grid of atlas tiles from uploaded BlitTilemapData in one cmd
+int gfx_draw_scroll_layer(uint32_t atlasBufferId, uint32_t tileDataBufferId, int16_t scrollX, int16_t scrollY, uint16_t y, uint16_t h, uint16_t lineScrollBufferId, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId); // Draw wrapping tilemap layer at scroll offset, lineScrollBufferId adds per line x offsets or SCROLL_LAYER_NO_LINE_SCROLL
+int gfx_draw_sprite_batch(uint32_t textureBufferId, const GpuSpriteInstance* instances, uint32_t cnt, uint16_t colKeyOrPal, uint8_t blendMode, uint16_t palBufferId); // Draw many sprites from one texture, split into as few cmds as fit
 int gfx_draw_tilemap(uint32_t tilemapDataBufferId, uint32_t tilemapStateBufferId, uint32_t tilemapAttribBufferId, int16_t x, int16_t y, uint16_t w, uint16_t h, uint8_t tileIdMask, uint8_t tileGroupMask, float time, uint32_t seed); // Draw tilemap, uses attribute map to draw tiles from tilemap data ( index of attributes )
 int gfx_draw_water(uint32_t tilemapDataBufferId, uint32_t tilemapStateBufferId, uint32_t tilemapAttribBufferId, int16_t x, int16_t y, uint16_t w, uint16_t h, uint8_t tileIdMask, uint8_t tileGroupMask, float time, uint32_t seed); // Draw tilemap, uses attribute map to draw tiles from tilemap data ( index of attributes )
 int gfx_link_tilemap(uint16_t tilemapDataBufferId, uint16_t tilemapStateBufferId, uint16_t tilemapDataBufferIds[9], uint16_t tilemapStateBufferIds[9]); // Link tilemap edges
@@ -312,8 +317,15 @@ int gfx_draw_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t col);
 int gfx_debug_set_gpu_debug(uint8_t dumpBufferUploads); // Enable gpu debug
 struct GpuCmd_Header* gfx_alloc_raw(uint32_t sz);       // alloc raw gpu cmd
 
+// precompiled cmd lists
+int gfx_begin_cmd_list(struct GpuCommandList_t* list);  // Record gfx_draw_* cmds into list instead of the current frame
+int gfx_end_cmd_list();                                 // Stop recording
+int gfx_upload_cmd_list(const struct GpuCommandList_t* list, uint8_t arenaId);     // Upload recorded list into a vdp1 ETextureFormat_CmdList buffer, returns buffer id or SDKErr_Fail
+int gfx_call_cmd_list(uint32_t cmdListBufferId, int16_t offsetX, int16_t offsetY);  // Replay uploaded cmd list, offset moves cmds with screen positions
+
 // vdp2 composite
 int gfx_composite(uint8_t blendMode);                   // composite vdp1 tile 
+int gfx_set_vdp2_background(const struct GpuCommandList_t* list);   // Hold recorded cmds ( eg. gfx_draw_scroll_layer ) on vdp2 as background under vdp1 tiles, re-send to scroll, null disables
 
 // 3d api
 int gfx_init_renderer3d();                              // alloc 3d renderer on gpu
@@ -1,63 +1,38 @@
 #pragma once
 
-#ifdef PICOCOM_SDL
-
-#define BEGIN_PROFILE_BLOCK_US() \
-    uint32_t t0, t1; \
-    t0=picocom_time_us_32(); \
-
-
-#define END_PROFILE_BLOCK_US() \
-    t1=picocom_time_us_32(); \
-
-
-#define PROFILE_REPORT_US() \
-    printf("took: %d us (%d ms)\n",t1-t0, (t1-t0)/1000); \
-
-
-#define PROFILE_REPORT_US_PREFIX(prefix) \
-    printf("%s took: %d us (%d ms)\n",prefix, t1-t0, (t1-t0)/1000); \
-
-// Full profile
-#define BEGIN_PROFILE() \
-    BEGIN_PROFILE_BLOCK_US(); \
-
-#define END_PROFILE() \
-    END_PROFILE_BLOCK_US(); \
-    PROFILE_REPORT_US(); \
-
-#else // native pico
-
 #include <stdint.h>
-#include "hardware/structs/systick.h"
-#include "hardware/timer.h"
+#include <inttypes.h>
+#include "picocom/devkit.h"
 
+// Cycle counter, see picocom_cycles_32
 #define BEGIN_PROFILE_BLOCK_CYCLES() \
-    systick_hw->csr = 0x5; \
-    systick_hw->rvr = 0x00FFFFFF; \
-    uint32_t newt, old; \
-    old=systick_hw->cvr; \
+    uint32_t c0, c1; \
+    c0=picocom_cycles_32(); \
 
 
 #define END_PROFILE_BLOCK_CYCLES() \
-    newt=systick_hw->cvr; \
+    c1=picocom_cycles_32(); \
 
 
 #define BEGIN_PROFILE_BLOCK_US() \
     uint32_t t0, t1; \
-    t0=time_us_32(); \
+    t0=picocom_time_us_32(); \
 
 
 #define END_PROFILE_BLOCK_US() \
-    t1=time_us_32(); \
+    t1=picocom_time_us_32(); \
 
 
 #define PROFILE_REPORT_US() \
     printf("took: %d us (%d ms)\n",t1-t0, (t1-t0)/1000); \
 
 
+#define PROFILE_REPORT_US_PREFIX(prefix) \
+    printf("%s took: %d us (%d ms)\n",prefix, t1-t0, (t1-t0)/1000); \
+
+
 #define PROFILE_REPORT_CYC() \
-    printf("took: %d cycles\n",old-newt); \
+    printf("took: %" PRIu32 " cycles (%" PRIu32 " ns)\n", (uint32_t)picocom_cycles_diff(c0, c1), (uint32_t)(((uint64_t)picocom_cycles_diff(c0, c1) * 1000) / picocom_cycles_per_us())); \
 
 
 // Full profile
@@ -70,6 +45,4 @@
     END_PROFILE_BLOCK_US(); \
     PROFILE_REPORT_US(); \
     PROFILE_REPORT_CYC(); \
-    
-#endif
-    
+
@@ -113,6 +113,7 @@ void main()
     vdpOptions.vdp2CmdFwdWriteBufferSz = 0;
     vdpOptions.gpuOptions.bufferRamSz = VDP1_GPU_RAM_SZ;
     vdpOptions.gpuOptions.enableFlash = true;
+    vdpOptions.gpuOptions.enableTilemapCaches = true;
 
 
     // init vdp core
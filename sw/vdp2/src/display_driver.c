@@ -32,6 +32,8 @@ uint16_t buffer1_data[320*240];
 uint16_t* buffer0 =  (uint16_t*)buffer0_data; // core0 init
 uint16_t* buffer1 =  (uint16_t*)buffer1_data; // core1 init
 uint16_t* main_buffer = (uint16_t*)buffer0_data;
+uint16_t* front_buffer = (uint16_t*)buffer1_data;
+bool is_flip_pending = false;
 bool is_display_inited = false;
 
 
@@ -134,14 +136,47 @@ uint16_t* get_display_buffer()
     return main_buffer;
 }
 
-uint16_t* flip_display_blocking()
+uint16_t* get_display_front_buffer()
+{
+    return front_buffer;
+}
+
+bool flip_display_async()
 {
     if(!is_display_inited)
-        return main_buffer;    
+        return true;
+    if(!flip_display_poll())
+        return false;
 #ifndef DISPLAY_NULL        
+    // scanout swaps on frame end, buffer returned in flip_display_poll
     queue_add_blocking_u32(&buffer0_queue, &main_buffer);
-    queue_remove_blocking_u32(&buffer1_queue, &main_buffer);    
+    front_buffer = main_buffer;
+    main_buffer = 0;
+    is_flip_pending = true;
 #endif
+    return true;
+}
+
+bool flip_display_poll()
+{
+    if(!is_flip_pending)
+        return true;
+    if(!queue_try_remove_u32(&buffer1_queue, &main_buffer))
+        return false;
+    is_flip_pending = false;
+    return true;
+}
+
+uint16_t* flip_display_blocking()
+{
+    if(!is_display_inited)
+        return main_buffer;    
+
+    while(!flip_display_poll())
+        tight_loop_contents();
+    flip_display_async();
+    while(!flip_display_poll())
+        tight_loop_contents();
     return main_buffer;
 }
 
@@ -11,5 +11,8 @@
 void display_driver_setup_clocks(); // init system clocks for dvi timings
 bool display_driver_init(); // init display
 uint16_t* get_display_buffer(); // get working back buffer
+uint16_t* get_display_front_buffer(); // get displayed front buffer ( previous frame after flip )
 uint16_t* flip_display_blocking(); // flip display & wait for next back buffer
+bool flip_display_async(); // queue back buffer to scanout, false if flip pending. No back buffer until flip_display_poll() completes
+bool flip_display_poll(); // true when scanout released back buffer
 bool display_driver_get_init();
\ No newline at end of file